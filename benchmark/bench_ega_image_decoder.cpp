@@ -0,0 +1,94 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assets/ega_image_decoder.hpp>
+#include <base/warnings.hpp>
+#include <data/game_traits.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <benchmark/benchmark.h>
+RIGEL_RESTORE_WARNINGS
+
+
+namespace
+{
+
+using rigel::data::GameTraits;
+using rigel::data::TileImageType;
+
+
+rigel::assets::ByteBuffer makeTestData(const std::size_t size)
+{
+  rigel::assets::ByteBuffer data(size);
+  for (auto i = 0u; i < size; ++i)
+  {
+    data[i] = static_cast<std::uint8_t>(i * 37 + i / 7);
+  }
+
+  return data;
+}
+
+
+void decodeTiledImage(benchmark::State& state, const TileImageType type)
+{
+  // Same size as a tile set (CZone)
+  const auto widthInTiles = GameTraits::CZone::tileSetImageWidth;
+  const auto numTiles = GameTraits::CZone::numTilesTotal;
+  const auto data = makeTestData(numTiles * GameTraits::bytesPerTile(type));
+
+  for (auto _ : state)
+  {
+    const auto image = rigel::assets::loadTiledImage(
+      data, widthInTiles, GameTraits::INGAME_PALETTE, type);
+    benchmark::DoNotOptimize(image.pixelData().data());
+  }
+}
+
+} // namespace
+
+
+static void BMDecodeTiledImageUnmasked(benchmark::State& state)
+{
+  decodeTiledImage(state, TileImageType::Unmasked);
+}
+
+BENCHMARK(BMDecodeTiledImageUnmasked);
+
+
+static void BMDecodeTiledImageMasked(benchmark::State& state)
+{
+  decodeTiledImage(state, TileImageType::Masked);
+}
+
+BENCHMARK(BMDecodeTiledImageMasked);
+
+
+static void BMDecodeSimplePlanarEgaBuffer(benchmark::State& state)
+{
+  // Same size as a full-screen image
+  const auto data = makeTestData(
+    GameTraits::viewportWidthPx * GameTraits::viewportHeightPx /
+    GameTraits::pixelsPerEgaByte * GameTraits::egaPlanes);
+
+  for (auto _ : state)
+  {
+    const auto pixels = rigel::assets::decodeSimplePlanarEgaBuffer(
+      data.begin(), data.end(), GameTraits::INGAME_PALETTE);
+    benchmark::DoNotOptimize(pixels.data());
+  }
+}
+
+BENCHMARK(BMDecodeSimplePlanarEgaBuffer);
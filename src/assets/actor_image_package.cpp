@@ -55,17 +55,27 @@ ActorImagePackage::ActorImagePackage(
 
     mDrawIndexById.push_back(drawIndex);
 
+    // Each frame header consists of 8 words: draw offset (x, y),
+    // height, width, image data offset (32 bit), and 2 words of padding
+    constexpr auto WORDS_PER_FRAME_HEADER = 8u;
+
+    vector<uint16_t> frameHeaderWords(numFrames * WORDS_PER_FRAME_HEADER);
+    entryReader.readU16Array(frameHeaderWords.data(), frameHeaderWords.size());
+
     vector<ActorFrameHeader> frameHeaders;
+    frameHeaders.reserve(numFrames);
     for (size_t frame = 0; frame < numFrames; ++frame)
     {
-      base::Vec2 drawOffset{entryReader.readS16(), entryReader.readS16()};
+      const auto pWords = &frameHeaderWords[frame * WORDS_PER_FRAME_HEADER];
+
+      base::Vec2 drawOffset{int16_t(pWords[0]), int16_t(pWords[1])};
 
-      const auto height = entryReader.readU16();
-      const auto width = entryReader.readU16();
+      const auto height = pWords[2];
+      const auto width = pWords[3];
       base::Size size{width, height};
 
-      const auto imageDataOffset = entryReader.readU32();
-      entryReader.skipBytes(4); // padding
+      const auto imageDataOffset =
+        uint32_t(pWords[4]) | (uint32_t(pWords[5]) << 16);
 
       frameHeaders.emplace_back(
         ActorFrameHeader{drawOffset, size, imageDataOffset});
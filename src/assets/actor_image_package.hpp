@@ -56,6 +56,12 @@ public:
   ActorImagePackage(ByteBuffer imageData, const ByteBuffer& actorInfoData);
 
   const ActorHeader& loadActorInfo(data::ActorID id) const;
+
+  bool hasActorInfo(data::ActorID id) const
+  {
+    return mHeadersById.count(id) != 0;
+  }
+
   data::Image loadImage(
     const ActorFrameHeader& frameHeader,
     const data::Palette16& palette) const;
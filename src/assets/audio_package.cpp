@@ -41,15 +41,22 @@ struct AudioDictEntry
 std::vector<AudioDictEntry> readAudioDict(const ByteBuffer& data)
 {
   const auto numOffsets = data.size() / sizeof(uint32_t);
+  if (numOffsets == 0)
+  {
+    throw std::invalid_argument("Corrupt Duke Nukem II AUDIOHED");
+  }
 
   std::vector<AudioDictEntry> dict;
   dict.reserve(numOffsets);
 
+  std::vector<std::uint32_t> offsets(numOffsets);
   LeStreamReader reader(data);
-  auto previousOffset = reader.readU32();
+  reader.readU32Array(offsets.data(), offsets.size());
+
+  auto previousOffset = offsets.front();
   for (auto i = 1u; i < numOffsets; ++i)
   {
-    const auto nextOffset = reader.readU32();
+    const auto nextOffset = offsets[i];
 
     const auto chunkSize = static_cast<int64_t>(nextOffset) - previousOffset;
 
@@ -76,16 +83,12 @@ AdlibSound parseAdlibSound(LeStreamReader& reader)
   const auto length = reader.readU32();
   sound.mSoundData.reserve(length);
   reader.skipBytes(sizeof(uint16_t)); // priority - not interesting for us
-  for (auto& setting : sound.mInstrumentSettings)
-  {
-    setting = reader.readU8();
-  }
+  reader.readU8Array(
+    sound.mInstrumentSettings.data(), sound.mInstrumentSettings.size());
   sound.mOctave = reader.readU8();
 
-  for (auto i = 0u; i < length; ++i)
-  {
-    sound.mSoundData.push_back(reader.readU8());
-  }
+  const auto soundData = reader.readBytes(length);
+  sound.mSoundData.assign(soundData.begin(), soundData.end());
 
   return sound;
 }
@@ -109,8 +112,10 @@ AudioPackage loadAdlibSoundData(
   {
     const auto& dictEntry = audioDict[i];
 
-    const auto soundStartIter = bundledAudioData.begin() + dictEntry.mOffset;
-    LeStreamReader reader(soundStartIter, soundStartIter + dictEntry.mSize);
+    LeStreamReader bundleReader(bundledAudioData);
+    bundleReader.skipBytes(dictEntry.mOffset);
+
+    LeStreamReader reader(bundleReader.readBytes(dictEntry.mSize));
     sounds.emplace_back(parseAdlibSound(reader));
   }
 
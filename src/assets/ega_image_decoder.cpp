@@ -16,15 +16,12 @@
 
 #include "ega_image_decoder.hpp"
 
-#include "assets/bitwise_iter.hpp"
-#include "assets/file_utils.hpp"
-#include "base/container_utils.hpp"
 #include "base/math_utils.hpp"
 #include "data/unit_conversions.hpp"
 
 #include <array>
 #include <cassert>
-#include <stdexcept>
+#include <cstdint>
 
 
 namespace rigel::assets
@@ -38,145 +35,143 @@ using data::tilesToPixels;
 namespace
 {
 
-using PalettizedPixelBuffer = std::vector<std::uint8_t>;
-
-
-size_t inferHeight(
-  const ByteBufferCIter begin,
-  const ByteBufferCIter end,
-  const size_t widthInTiles,
-  const size_t bytesPerTile)
-{
-  const auto availableBytes = distance(begin, end);
-  const auto numTiles = static_cast<size_t>(availableBytes / bytesPerTile);
-  return base::integerDivCeil(numTiles, widthInTiles);
-}
-
-
-/** Decode EGA mask plane
+/* EGA image data is stored as bit planes: Each byte holds one bit for each
+ * of 8 consecutive pixels, with the most significant bit belonging to the
+ * left-most pixel. A pixel's palette index is made up of one bit from each of
+ * the 4 color planes.
  *
- * Pre-conditions:
- *   source and target can be advanced pixelCount times.
+ * Instead of walking the planes bit by bit, we use a lookup table which
+ * spreads out the 8 bits of a byte over the 8 bytes of a 64-bit word, one bit
+ * per byte. Combining the spread-out planes with a shift and OR then yields
+ * the palette indices for all 8 pixels at once, one per byte.
  */
-template <typename SourceIter, typename TargetIter>
-SourceIter readEgaMaskPlane(
-  SourceIter source,
-  TargetIter target,
-  const size_t pixelCount)
-{
-  for (size_t i = 0; i < pixelCount; ++i)
-  {
-    *target++ = *source++;
-  }
+constexpr auto PIXELS_PER_BYTE = GameTraits::pixelsPerEgaByte;
+static_assert(PIXELS_PER_BYTE == 8);
+static_assert(GameTraits::tileSize == PIXELS_PER_BYTE);
 
-  return source;
-}
+using PixelGroup = std::uint64_t;
 
-/** Decode EGA color data (4 planes)
- *
- * Pre-conditions:
- *   target points to zero-initialized buffer of bytes.
- *   target can be advanced pixelCount times.
- *   source can be advanced pixelCount*4 times.
- */
-template <typename SourceIter, typename TargetIter>
-SourceIter readEgaColorData(
-  SourceIter source,
-  TargetIter target,
-  const size_t pixelCount)
+
+constexpr std::array<PixelGroup, 256> makeBitSpreadTable()
 {
-  for (auto plane = 0u; plane < GameTraits::egaPlanes; ++plane)
+  std::array<PixelGroup, 256> table{};
+  for (auto byte = 0u; byte < table.size(); ++byte)
   {
-    auto targetIterForPlane = target;
-
-    for (auto pixel = 0u; pixel < pixelCount; ++pixel)
+    auto spread = PixelGroup{0};
+    for (auto pixel = 0u; pixel < PIXELS_PER_BYTE; ++pixel)
     {
-      const auto planeBit = *source++;
-      *targetIterForPlane++ |= planeBit << plane;
+      const auto bitMask = 0x80u >> pixel;
+      if (byte & bitMask)
+      {
+        spread |= PixelGroup{1} << (pixel * 8);
+      }
     }
+
+    table[byte] = spread;
   }
 
-  return source;
+  return table;
 }
 
 
-/** Decode EGA monochromatic data (1 plane)
+constexpr auto BIT_SPREAD_TABLE = makeBitSpreadTable();
+
+
+/** Combine 4 color plane bytes into 8 palette indices
  *
- * Pre-conditions:
- *   target points to buffer of Pixels.
- *   target can be advanced pixelCount times.
- *   source can be advanced pixelCount times.
+ * The index for the n-th pixel (from the left) ends up in the n-th byte
+ * (counting from the least significant one).
  */
-template <typename SourceIter, typename TargetIter>
-SourceIter readEgaMonochromeData(
-  SourceIter source,
-  TargetIter target,
-  const size_t pixelCount)
+PixelGroup
+  decodeColorPlanes(const std::uint8_t* pPlaneBytes, const size_t planeStride)
 {
-  for (size_t i = 0; i < pixelCount; ++i)
+  return BIT_SPREAD_TABLE[pPlaneBytes[0]] |
+    (BIT_SPREAD_TABLE[pPlaneBytes[planeStride]] << 1) |
+    (BIT_SPREAD_TABLE[pPlaneBytes[planeStride * 2]] << 2) |
+    (BIT_SPREAD_TABLE[pPlaneBytes[planeStride * 3]] << 3);
+}
+
+
+void writePixels(
+  const PixelGroup indices,
+  const data::Palette16& palette,
+  data::Pixel* pTarget)
+{
+  for (auto pixel = 0u; pixel < PIXELS_PER_BYTE; ++pixel)
   {
-    const auto pixelPresent = *source++ != 0;
-    *target++ = pixelPresent ? data::Pixel{255, 255, 255, 255}
-                             : data::Pixel{0, 0, 0, 255};
+    pTarget[pixel] = palette[(indices >> (pixel * 8)) & 0xF];
   }
-
-  return source;
 }
 
 
-/** Apply mask to decoded pixels
- *
- * Pre-conditions:
- *   pixels points to buffer of Pixels.
- *   maskValues points to buffer of bools.
- *   pixels can be advanced pixelCount times.
- *   maskValues can be advanced pixelCount times.
- */
-template <typename MaskIter, typename PixelBufferIter>
-void applyEgaMask(
-  MaskIter maskValues,
-  PixelBufferIter pixels,
-  const size_t pixelCount)
+/** Make pixels transparent where the corresponding mask bit is set */
+void applyEgaMask(const std::uint8_t maskByte, data::Pixel* pTarget)
 {
-  for (size_t i = 0; i < pixelCount; ++i, ++pixels)
+  const auto maskBits = BIT_SPREAD_TABLE[maskByte];
+  for (auto pixel = 0u; pixel < PIXELS_PER_BYTE; ++pixel)
   {
-    const auto maskActive = *maskValues++;
-    if (maskActive)
+    if ((maskBits >> (pixel * 8)) & 1)
     {
-      pixels->a = 0;
+      pTarget[pixel].a = 0;
     }
   }
 }
 
 
+void writeMonochromePixels(const std::uint8_t planeByte, data::Pixel* pTarget)
+{
+  const auto bits = BIT_SPREAD_TABLE[planeByte];
+  for (auto pixel = 0u; pixel < PIXELS_PER_BYTE; ++pixel)
+  {
+    pTarget[pixel] = ((bits >> (pixel * 8)) & 1)
+      ? data::Pixel{255, 255, 255, 255}
+      : data::Pixel{0, 0, 0, 255};
+  }
+}
+
+
+/** Decode image data made up of 8x8 pixel tiles
+ *
+ * Each row of a tile consists of bytesPerRow bytes, which are handed to
+ * decodeRow together with a pointer to the 8 target pixels.
+ */
 template <typename Callable>
-data::PixelBuffer decodeTiledEgaData(
-  const ByteBufferCIter dataIter,
+data::Image decodeTiledEgaData(
+  const ByteBufferCIter begin,
+  const ByteBufferCIter end,
   const std::size_t widthInTiles,
-  const std::size_t heightInTiles,
+  const std::size_t bytesPerRow,
   Callable decodeRow)
 {
+  const auto bytesPerTile = bytesPerRow * GameTraits::tileSize;
+  const auto availableBytes = static_cast<size_t>(distance(begin, end));
+  const auto numTiles = availableBytes / bytesPerTile;
+  const auto heightInTiles = base::integerDivCeil(numTiles, widthInTiles);
+
   const auto targetBufferStride = tilesToPixels(widthInTiles);
   PixelBuffer pixels(
     widthInTiles * heightInTiles * GameTraits::tileSizeSquared);
 
-  BitWiseIterator<ByteBufferCIter> bitsIter(dataIter);
-  for (auto row = 0u; row < heightInTiles; ++row)
+  const auto pData = availableBytes > 0 ? &*begin : nullptr;
+  for (auto tile = 0u; tile < numTiles; ++tile)
   {
-    for (auto col = 0u; col < widthInTiles; ++col)
+    const auto row = tile / widthInTiles;
+    const auto col = tile % widthInTiles;
+    const auto pTileData = pData + tile * bytesPerTile;
+
+    for (size_t rowInTile = 0u; rowInTile < GameTraits::tileSize; ++rowInTile)
     {
-      for (size_t rowInTile = 0u; rowInTile < GameTraits::tileSize; ++rowInTile)
-      {
-        const auto insertStart = tilesToPixels(col) +
-          (tilesToPixels(row) + rowInTile) * targetBufferStride;
-        const auto targetPixelIter = pixels.begin() + insertStart;
+      const auto insertStart = tilesToPixels(col) +
+        (tilesToPixels(row) + rowInTile) * targetBufferStride;
 
-        bitsIter = decodeRow(bitsIter, targetPixelIter);
-      }
+      decodeRow(pTileData + rowInTile * bytesPerRow, &pixels[insertStart]);
     }
   }
 
-  return pixels;
+  return data::Image(
+    std::move(pixels),
+    tilesToPixels(widthInTiles),
+    tilesToPixels(heightInTiles));
 }
 
 } // namespace
@@ -189,16 +184,22 @@ data::PixelBuffer decodeSimplePlanarEgaBuffer(
 {
   const auto numBytes = distance(begin, end);
   assert(numBytes > 0);
-  const auto numPixels = static_cast<size_t>(numBytes / GameTraits::egaPlanes) *
-    GameTraits::pixelsPerEgaByte;
 
-  BitWiseIterator<ByteBufferCIter> bitsIter(begin);
-  PalettizedPixelBuffer indexedPixels(numPixels, 0);
-  readEgaColorData(bitsIter, indexedPixels.begin(), numPixels);
+  // The planes are stored one after another, each one covering all pixels
+  const auto bytesPerPlane =
+    static_cast<size_t>(numBytes / GameTraits::egaPlanes);
+  const auto numPixels = bytesPerPlane * PIXELS_PER_BYTE;
 
-  return utils::transformed(indexedPixels, [&palette](const auto colorIndex) {
-    return palette[colorIndex];
-  });
+  PixelBuffer pixels(numPixels);
+
+  const auto pData = &*begin;
+  for (auto i = 0u; i < bytesPerPlane; ++i)
+  {
+    const auto indices = decodeColorPlanes(pData + i, bytesPerPlane);
+    writePixels(indices, palette, &pixels[i * PIXELS_PER_BYTE]);
+  }
+
+  return pixels;
 }
 
 
@@ -209,44 +210,25 @@ data::Image loadTiledImage(
   const data::Palette16& palette,
   const data::TileImageType type)
 {
-  const auto heightInTiles =
-    inferHeight(begin, end, widthInTiles, GameTraits::bytesPerTile(type));
+  const auto isMasked = type == data::TileImageType::Masked;
+  const auto bytesPerRow = GameTraits::numPlanes(type);
 
-  auto pixels = decodeTiledEgaData(
+  // Within a tile, all planes for a row are stored together, with the mask
+  // plane coming first.
+  return decodeTiledEgaData(
     begin,
+    end,
     widthInTiles,
-    heightInTiles,
-    [&palette, type](auto sourceBitsIter, const auto targetPixelIter) {
-      const auto isMasked = type == data::TileImageType::Masked;
-      array<bool, GameTraits::tileSize> pixelMask;
-      if (isMasked)
-      {
-        sourceBitsIter = readEgaMaskPlane(
-          sourceBitsIter, pixelMask.begin(), GameTraits::tileSize);
-      }
-
-      array<uint8_t, GameTraits::tileSize> indexedPixels;
-      indexedPixels.fill(0);
-      sourceBitsIter = readEgaColorData(
-        sourceBitsIter, indexedPixels.begin(), GameTraits::tileSize);
-
-      for (auto i = 0; i < GameTraits::tileSize; ++i)
-      {
-        *(targetPixelIter + i) = palette[indexedPixels[i]];
-      }
+    bytesPerRow,
+    [&palette, isMasked](const std::uint8_t* pRow, data::Pixel* pTarget) {
+      const auto pColorPlanes = isMasked ? pRow + 1 : pRow;
+      writePixels(decodeColorPlanes(pColorPlanes, 1), palette, pTarget);
 
       if (isMasked)
       {
-        applyEgaMask(pixelMask.begin(), targetPixelIter, GameTraits::tileSize);
+        applyEgaMask(pRow[0], pTarget);
       }
-
-      return sourceBitsIter;
     });
-
-  return data::Image(
-    std::move(pixels),
-    tilesToPixels(widthInTiles),
-    tilesToPixels(heightInTiles));
 }
 
 
@@ -255,28 +237,15 @@ data::Image loadTiledFontBitmap(
   const ByteBufferCIter end,
   const std::size_t widthInTiles)
 {
-  const auto heightInTiles =
-    inferHeight(begin, end, widthInTiles, GameTraits::bytesPerFontTile());
-
-  auto pixels = decodeTiledEgaData(
+  return decodeTiledEgaData(
     begin,
+    end,
     widthInTiles,
-    heightInTiles,
-    [](auto sourceBitsIter, const auto targetPixelIter) {
-      array<bool, GameTraits::tileSize> pixelMask;
-      sourceBitsIter = readEgaMaskPlane(
-        sourceBitsIter, pixelMask.begin(), GameTraits::tileSize);
-
-      sourceBitsIter = readEgaMonochromeData(
-        sourceBitsIter, targetPixelIter, GameTraits::tileSize);
-      applyEgaMask(pixelMask.begin(), targetPixelIter, GameTraits::tileSize);
-      return sourceBitsIter;
+    GameTraits::fontEgaPlanes,
+    [](const std::uint8_t* pRow, data::Pixel* pTarget) {
+      writeMonochromePixels(pRow[1], pTarget);
+      applyEgaMask(pRow[0], pTarget);
     });
-
-  return data::Image(
-    std::move(pixels),
-    tilesToPixels(widthInTiles),
-    tilesToPixels(heightInTiles));
 }
 
 } // namespace rigel::assets
@@ -17,8 +17,10 @@
 #include "file_utils.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
+#include <type_traits>
 
 
 namespace rigel::assets
@@ -32,6 +34,13 @@ namespace
 
 const char* OUT_OF_DATA_ERROR_MSG = "No more data in stream";
 
+#if defined(_MSC_VER) ||                                                       \
+  (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+constexpr auto IS_LITTLE_ENDIAN_HOST = true;
+#else
+constexpr auto IS_LITTLE_ENDIAN_HOST = false;
+#endif
+
 }
 
 
@@ -74,42 +83,51 @@ std::string asText(const ByteBuffer& buffer)
 }
 
 
+LeStreamReader::LeStreamReader(const base::ArrayView<uint8_t> data)
+  : mpCurrentByte(data.data())
+  , mpDataEnd(data.data() + data.size())
+{
+}
+
+
 LeStreamReader::LeStreamReader(const ByteBuffer& data)
-  : LeStreamReader(data.begin(), data.end())
+  : mpCurrentByte(data.data())
+  , mpDataEnd(data.data() + data.size())
 {
 }
 
 
 LeStreamReader::LeStreamReader(ByteBufferCIter begin, ByteBufferCIter end)
-  : mCurrentByteIter(begin)
-  , mDataEnd(end)
+  : mpCurrentByte(begin != end ? &*begin : nullptr)
+  , mpDataEnd(mpCurrentByte + distance(begin, end))
 {
 }
 
 
 uint8_t LeStreamReader::readU8()
 {
-  if (mCurrentByteIter == mDataEnd)
-  {
-    throw runtime_error(OUT_OF_DATA_ERROR_MSG);
-  }
-  return *mCurrentByteIter++;
+  ensureAvailable(1);
+  return *mpCurrentByte++;
 }
 
 
 uint16_t LeStreamReader::readU16()
 {
-  const auto lsb = readU8();
-  const auto msb = readU8();
+  ensureAvailable(2);
+  const auto lsb = mpCurrentByte[0];
+  const auto msb = mpCurrentByte[1];
+  mpCurrentByte += 2;
   return lsb | uint16_t(msb << 8);
 }
 
 
 uint32_t LeStreamReader::readU24()
 {
-  const auto lsb = readU8();
-  const auto middle = readU8();
-  const auto msb = readU8();
+  ensureAvailable(3);
+  const auto lsb = mpCurrentByte[0];
+  const auto middle = mpCurrentByte[1];
+  const auto msb = mpCurrentByte[2];
+  mpCurrentByte += 3;
 
   return lsb | (middle << 8) | (msb << 16);
 }
@@ -117,8 +135,9 @@ uint32_t LeStreamReader::readU24()
 
 uint32_t LeStreamReader::readU32()
 {
-  const auto lowWord = readU16();
-  const auto highWord = readU16();
+  ensureAvailable(4);
+  const auto lowWord = uint32_t{readU16()};
+  const auto highWord = uint32_t{readU16()};
   return lowWord | (highWord << 16);
 }
 
@@ -151,86 +170,173 @@ int32_t LeStreamReader::readS32()
 
 
 template <typename Callable>
-auto LeStreamReader::withPreservingCurrentIter(Callable func)
+auto LeStreamReader::withPreservingCurrentPosition(Callable func)
 {
-  const auto currentIter = mCurrentByteIter;
+  const auto pCurrentByte = mpCurrentByte;
   const auto result = func();
-  mCurrentByteIter = currentIter;
+  mpCurrentByte = pCurrentByte;
   return result;
 }
 
 
 uint8_t LeStreamReader::peekU8()
 {
-  return withPreservingCurrentIter([this]() { return readU8(); });
+  return withPreservingCurrentPosition([this]() { return readU8(); });
 }
 
 
 uint16_t LeStreamReader::peekU16()
 {
-  return withPreservingCurrentIter([this]() { return readU16(); });
+  return withPreservingCurrentPosition([this]() { return readU16(); });
 }
 
 
 uint32_t LeStreamReader::peekU24()
 {
-  return withPreservingCurrentIter([this]() { return readU24(); });
+  return withPreservingCurrentPosition([this]() { return readU24(); });
 }
 
 
 uint32_t LeStreamReader::peekU32()
 {
-  return withPreservingCurrentIter([this]() { return readU32(); });
+  return withPreservingCurrentPosition([this]() { return readU32(); });
 }
 
 
 int8_t LeStreamReader::peekS8()
 {
-  return withPreservingCurrentIter([this]() { return readS8(); });
+  return withPreservingCurrentPosition([this]() { return readS8(); });
 }
 
 
 int16_t LeStreamReader::peekS16()
 {
-  return withPreservingCurrentIter([this]() { return readS16(); });
+  return withPreservingCurrentPosition([this]() { return readS16(); });
 }
 
 
 int32_t LeStreamReader::peekS24()
 {
-  return withPreservingCurrentIter([this]() { return readS24(); });
+  return withPreservingCurrentPosition([this]() { return readS24(); });
 }
 
 
 int32_t LeStreamReader::peekS32()
 {
-  return withPreservingCurrentIter([this]() { return readS32(); });
+  return withPreservingCurrentPosition([this]() { return readS32(); });
 }
 
 
-void LeStreamReader::skipBytes(const size_t count)
+base::ArrayView<uint8_t> LeStreamReader::readBytes(const size_t count)
+{
+  ensureAvailable(count);
+
+  const auto pStart = mpCurrentByte;
+  mpCurrentByte += count;
+  return base::ArrayView<uint8_t>{
+    pStart, static_cast<base::ArrayView<uint8_t>::size_type>(count)};
+}
+
+
+template <typename T>
+void LeStreamReader::readArray(T* pDestination, const size_t count)
 {
-  assert(distance(mCurrentByteIter, mDataEnd) >= 0);
-  const auto availableBytes =
-    static_cast<size_t>(distance(mCurrentByteIter, mDataEnd));
-  if (availableBytes < count)
+  static_assert(std::is_integral_v<T>);
+
+  if (count > availableBytes() / sizeof(T))
   {
     throw runtime_error(OUT_OF_DATA_ERROR_MSG);
   }
 
-  advance(mCurrentByteIter, count);
+  const auto numBytes = count * sizeof(T);
+
+  if constexpr (IS_LITTLE_ENDIAN_HOST)
+  {
+    if (numBytes > 0)
+    {
+      memcpy(pDestination, mpCurrentByte, numBytes);
+    }
+  }
+  else
+  {
+    using UnsignedT = make_unsigned_t<T>;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      const auto pElementStart = mpCurrentByte + i * sizeof(T);
+
+      auto value = UnsignedT{0};
+      for (size_t byte = 0; byte < sizeof(T); ++byte)
+      {
+        value |= static_cast<UnsignedT>(pElementStart[byte]) << (byte * 8);
+      }
+
+      pDestination[i] = static_cast<T>(value);
+    }
+  }
+
+  mpCurrentByte += numBytes;
+}
+
+
+void LeStreamReader::readU8Array(uint8_t* pDestination, const size_t count)
+{
+  readArray(pDestination, count);
+}
+
+
+void LeStreamReader::readU16Array(uint16_t* pDestination, const size_t count)
+{
+  readArray(pDestination, count);
+}
+
+
+void LeStreamReader::readU32Array(uint32_t* pDestination, const size_t count)
+{
+  readArray(pDestination, count);
+}
+
+
+void LeStreamReader::readS16Array(int16_t* pDestination, const size_t count)
+{
+  readArray(pDestination, count);
+}
+
+
+void LeStreamReader::skipBytes(const size_t count)
+{
+  ensureAvailable(count);
+  mpCurrentByte += count;
 }
 
 
 bool LeStreamReader::hasData() const
 {
-  return mCurrentByteIter != mDataEnd;
+  return mpCurrentByte != mpDataEnd;
+}
+
+
+base::ArrayView<uint8_t> LeStreamReader::remainingData() const
+{
+  return base::ArrayView<uint8_t>{
+    mpCurrentByte,
+    static_cast<base::ArrayView<uint8_t>::size_type>(availableBytes())};
 }
 
 
-ByteBufferCIter LeStreamReader::currentIter() const
+size_t LeStreamReader::availableBytes() const
 {
-  return mCurrentByteIter;
+  assert(mpCurrentByte <= mpDataEnd);
+  return static_cast<size_t>(mpDataEnd - mpCurrentByte);
+}
+
+
+void LeStreamReader::ensureAvailable(const size_t count) const
+{
+  if (availableBytes() < count)
+  {
+    throw runtime_error(OUT_OF_DATA_ERROR_MSG);
+  }
 }
 
 
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "assets/byte_buffer.hpp"
+#include "base/array_view.hpp"
 
 #include <cstdint>
 #include <filesystem>
@@ -46,11 +47,15 @@ std::string asText(const ByteBuffer& buffer);
 
 /** Offers checked reading of little-endian data from a byte buffer
  *
- * All readX() methods will throw if there is not enough data left.
+ * The reader doesn't own the data, it can read from any contiguous block of
+ * memory. All readX() methods will throw if there is not enough data left.
+ * The bulk readXArray() methods check the size only once for the whole
+ * array, and copy the data directly on little-endian hosts.
  */
 class LeStreamReader
 {
 public:
+  explicit LeStreamReader(base::ArrayView<std::uint8_t> data);
   explicit LeStreamReader(const ByteBuffer& data);
   LeStreamReader(ByteBufferCIter begin, ByteBufferCIter end);
 
@@ -76,16 +81,35 @@ public:
   std::int32_t peekS24();
   std::int32_t peekS32();
 
+  /** Read the given number of bytes without copying them
+   *
+   * The returned view points into the data the reader was created for.
+   */
+  base::ArrayView<std::uint8_t> readBytes(std::size_t count);
+
+  void readU8Array(std::uint8_t* pDestination, std::size_t count);
+  void readU16Array(std::uint16_t* pDestination, std::size_t count);
+  void readU32Array(std::uint32_t* pDestination, std::size_t count);
+  void readS16Array(std::int16_t* pDestination, std::size_t count);
+
   void skipBytes(std::size_t count);
   bool hasData() const;
-  ByteBufferCIter currentIter() const;
+
+  /** View of the data which hasn't been read yet */
+  base::ArrayView<std::uint8_t> remainingData() const;
 
 private:
   template <typename Callable>
-  auto withPreservingCurrentIter(Callable func);
+  auto withPreservingCurrentPosition(Callable func);
+
+  template <typename T>
+  void readArray(T* pDestination, std::size_t count);
+
+  std::size_t availableBytes() const;
+  void ensureAvailable(std::size_t count) const;
 
-  ByteBufferCIter mCurrentByteIter;
-  const ByteBufferCIter mDataEnd;
+  const std::uint8_t* mpCurrentByte;
+  const std::uint8_t* mpDataEnd;
 };
 
 
@@ -31,6 +31,7 @@
 #include <array>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 
 /* Duke Nukem II level loader
@@ -124,9 +125,7 @@ ByteBuffer readExtraMaskedTileBits(const LeStreamReader& levelReader)
   extraInfoReader.skipBytes(GameTraits::mapDataWords * sizeof(uint16_t));
   const auto extraInfoSize = extraInfoReader.readU16();
 
-  LeStreamReader rleReader(
-    extraInfoReader.currentIter(),
-    extraInfoReader.currentIter() + extraInfoSize);
+  LeStreamReader rleReader(extraInfoReader.readBytes(extraInfoSize));
 
   ByteBuffer maskedTileOffsets;
   // The uncompressed masked tile extra bits contain 2 bits for each tile, so
@@ -535,10 +534,12 @@ LevelData loadLevel(
 
   LevelHeader header(levelReader);
   ActorList actors;
-  for (size_t i = 0; i < header.numActorWords / 3u; ++i)
+  std::vector<uint16_t> actorWords(header.numActorWords / 3u * 3u);
+  levelReader.readU16Array(actorWords.data(), actorWords.size());
+  for (size_t i = 0; i < actorWords.size(); i += 3)
   {
-    const auto type = levelReader.readU16();
-    const base::Vec2 position{levelReader.readU16(), levelReader.readU16()};
+    const auto type = actorWords[i];
+    const base::Vec2 position{actorWords[i + 1], actorWords[i + 2]};
     if (isValidActorId(type))
     {
       actors.emplace_back(
@@ -572,14 +573,15 @@ LevelData loadLevel(
       return static_cast<uint8_t>(extraBits << 5);
     };
 
-  LeStreamReader tileDataReader(
-    levelReader.currentIter(),
-    levelReader.currentIter() + width * height * sizeof(uint16_t));
+  std::vector<uint16_t> tileData(width * height);
+  levelReader.readU16Array(tileData.data(), tileData.size());
+
+  auto iTileSpec = tileData.cbegin();
   for (int y = 0; y < height; ++y)
   {
     for (int x = 0; x < width; ++x)
     {
-      const auto tileSpec = tileDataReader.readU16();
+      const auto tileSpec = *iTileSpec++;
 
       if (tileSpec & 0x8000)
       {
@@ -637,10 +639,12 @@ LevelData loadLevel(
 
   auto backdropImage = resources.loadBackdrop(header.backdrop);
   std::optional<data::Image> alternativeBackdropImage;
+  std::string alternativeBackdropName;
   if (header.flagBitSet(0x40) || header.flagBitSet(0x80))
   {
-    alternativeBackdropImage = resources.loadBackdrop(
-      backdropNameFromNumber(header.alternativeBackdropNumber));
+    alternativeBackdropName =
+      backdropNameFromNumber(header.alternativeBackdropNumber);
+    alternativeBackdropImage = resources.loadBackdrop(alternativeBackdropName);
   }
 
   auto [actorDescriptions, playerSpawnPosition, playerFacingLeft] =
@@ -651,6 +655,9 @@ LevelData loadLevel(
     std::move(tileSet.mTiles),
     std::move(backdropImage),
     std::move(alternativeBackdropImage),
+    header.CZone,
+    header.backdrop,
+    std::move(alternativeBackdropName),
     std::move(map),
     std::move(actorDescriptions),
     playerSpawnPosition,
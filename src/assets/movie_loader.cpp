@@ -112,10 +112,7 @@ data::Palette256 readPalette(LeStreamReader& reader)
     throw invalid_argument(INVALID_MOVIE_FILE);
   }
   reader.skipBytes(4); // always 1
-  const auto palette =
-    load6bitPalette256(reader.currentIter(), reader.currentIter() + 768);
-  reader.skipBytes(768);
-  return palette;
+  return load6bitPalette256(reader.readBytes(768));
 }
 
 
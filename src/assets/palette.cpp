@@ -37,13 +37,8 @@ std::uint8_t extend6bitColorValue(const std::uint8_t value)
 
 
 template <typename PaletteType, typename PreProcessFunc>
-PaletteType load6bitPalette(
-  const ByteBufferCIter begin,
-  const ByteBufferCIter end,
-  PreProcessFunc preProcess)
+PaletteType load6bitPalette(LeStreamReader reader, PreProcessFunc preProcess)
 {
-  LeStreamReader reader(begin, end);
-
   PaletteType palette;
   for (auto& entry : palette)
   {
@@ -55,13 +50,24 @@ PaletteType load6bitPalette(
   return palette;
 }
 
+
+data::Palette256 load6bitPalette256Impl(LeStreamReader reader)
+{
+  return load6bitPalette<data::Palette256>(reader, [](const auto entry) {
+    // 256 color palettes use the standard VGA 6-bit format and need no
+    // conversion.
+    return entry;
+  });
+}
+
 } // namespace
 
 
 data::Palette16
   load6bitPalette16(ByteBufferCIter begin, const ByteBufferCIter end)
 {
-  return load6bitPalette<data::Palette16>(begin, end, [](const auto entry) {
+  const auto reader = LeStreamReader{begin, end};
+  return load6bitPalette<data::Palette16>(reader, [](const auto entry) {
     // Duke Nukem 2 uses a non-standard 6-bit palette format, where the
     // maximum number is 68 instead of 63. This maps Duke 2 palette values to
     // normal 6-bit VGA/EGA values.
@@ -84,11 +90,13 @@ data::Palette16
 data::Palette256
   load6bitPalette256(ByteBufferCIter begin, const ByteBufferCIter end)
 {
-  return load6bitPalette<data::Palette256>(begin, end, [](const auto entry) {
-    // 256 color palettes use the standard VGA 6-bit format and need no
-    // conversion.
-    return entry;
-  });
+  return load6bitPalette256Impl(LeStreamReader{begin, end});
+}
+
+
+data::Palette256 load6bitPalette256(const base::ArrayView<std::uint8_t> data)
+{
+  return load6bitPalette256Impl(LeStreamReader{data});
 }
 
 } // namespace rigel::assets
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "assets/byte_buffer.hpp"
+#include "base/array_view.hpp"
 #include "data/palette.hpp"
 
 
@@ -25,6 +26,7 @@ namespace rigel::assets
 
 data::Palette16 load6bitPalette16(ByteBufferCIter begin, ByteBufferCIter end);
 data::Palette256 load6bitPalette256(ByteBufferCIter begin, ByteBufferCIter end);
+data::Palette256 load6bitPalette256(base::ArrayView<std::uint8_t> data);
 
 
 inline data::Palette16 load6bitPalette16(const ByteBuffer& buffer)
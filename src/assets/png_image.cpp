@@ -79,6 +79,19 @@ std::optional<data::Image> loadPng(base::ArrayView<std::uint8_t> data)
 }
 
 
+std::optional<base::Size> loadPngSize(const std::string& path)
+{
+  int width = 0;
+  int height = 0;
+  if (!stbi_info(path.c_str(), &width, &height, nullptr))
+  {
+    return {};
+  }
+
+  return base::Size{width, height};
+}
+
+
 bool savePng(const std::string& path, const data::Image& image)
 {
   const auto width = static_cast<int>(image.width());
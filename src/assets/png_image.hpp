@@ -18,6 +18,7 @@
 
 #include "base/array_view.hpp"
 #include "base/image.hpp"
+#include "base/spatial_types.hpp"
 
 #include <optional>
 #include <string>
@@ -28,6 +29,9 @@ namespace rigel::assets
 std::optional<data::Image> loadPng(const std::string& path);
 std::optional<data::Image> loadPng(base::ArrayView<std::uint8_t> data);
 
+/** Read the dimensions of a PNG file without decoding the image data */
+std::optional<base::Size> loadPngSize(const std::string& path);
+
 bool savePng(const std::string& path, const data::Image& image);
 
 } // namespace rigel::assets
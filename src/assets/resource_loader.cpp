@@ -23,9 +23,11 @@
 #include "assets/png_image.hpp"
 #include "assets/voc_decoder.hpp"
 #include "base/container_utils.hpp"
+#include "base/string_utils.hpp"
 #include "data/game_traits.hpp"
 #include "data/unit_conversions.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
@@ -83,9 +85,7 @@ std::string replacementSpriteImageName(const int id, const int frame)
 }
 
 
-std::optional<data::Image> loadReplacementTilesetIfPresent(
-  const fs::path& resourcePath,
-  std::string_view name)
+std::optional<std::string> replacementTilesetName(std::string_view name)
 {
   using namespace std::literals;
 
@@ -100,10 +100,46 @@ std::optional<data::Image> loadReplacementTilesetIfPresent(
   }
 
   const auto number = matches[1].str();
-  const auto replacementName = "tileset"s + number + ".png";
-  const auto replacementPath = resourcePath / replacementName;
+  return "tileset"s + number + ".png";
+}
+
+
+template <typename FileIndex>
+FileIndex indexDirectory(const fs::path& path)
+{
+  FileIndex index;
+
+  std::error_code err;
+  auto iDirectory = fs::directory_iterator{
+    path, fs::directory_options::skip_permission_denied, err};
+  if (err)
+  {
+    return index;
+  }
+
+  for (const auto& entry : iDirectory)
+  {
+    if (entry.is_regular_file(err) && !err)
+    {
+      index.emplace(
+        strings::toLowercase(entry.path().filename().u8string()), entry.path());
+    }
+  }
+
+  return index;
+}
+
 
-  return loadPng(replacementPath.u8string());
+template <typename FileIndex>
+std::optional<fs::path>
+  lookUpFile(const FileIndex& index, const std::string& lowercaseName)
+{
+  if (const auto iEntry = index.find(lowercaseName); iEntry != index.end())
+  {
+    return iEntry->second;
+  }
+
+  return {};
 }
 
 
@@ -145,6 +181,7 @@ ResourceLoader::ResourceLoader(
   : mGamePath(std::move(gamePath))
   , mModPaths(std::move(modPaths))
   , mEnableTopLevelMods(enableTopLevelMods)
+  , mModFileIndex(scanModFiles())
   , mFilePackage(mGamePath / "NUKEM2.CMP")
   , mActorImagePackage(
       file(ActorImagePackage::IMAGE_DATA_FILE),
@@ -153,22 +190,42 @@ ResourceLoader::ResourceLoader(
 }
 
 
-template <typename TryLoadFunc, typename T>
-std::optional<T> ResourceLoader::tryLoadReplacement(TryLoadFunc&& tryLoad) const
+void ResourceLoader::rescanModFiles()
 {
-  for (auto iPath = mModPaths.rbegin(); iPath != mModPaths.rend(); ++iPath)
+  mModFileIndex = scanModFiles();
+}
+
+
+auto ResourceLoader::scanModFiles() const -> ModFileIndex
+{
+  auto index = ModFileIndex{};
+
+  index.mModDirectories =
+    utils::transformed(mModPaths, indexDirectory<FileIndex>);
+
+  if (mEnableTopLevelMods)
   {
-    if (auto oReplacement = tryLoad(*iPath))
-    {
-      return *oReplacement;
-    }
+    index.mTopLevelFiles = indexDirectory<FileIndex>(mGamePath);
+    index.mAssetReplacements =
+      indexDirectory<FileIndex>(mGamePath / ASSET_REPLACEMENTS_PATH);
   }
 
-  if (mEnableTopLevelMods)
+  return index;
+}
+
+
+std::optional<fs::path>
+  ResourceLoader::findModFile(std::string_view name) const
+{
+  const auto lowercaseName = strings::toLowercase(name);
+
+  const auto& directories = mModFileIndex.mModDirectories;
+  for (auto iIndex = directories.rbegin(); iIndex != directories.rend();
+       ++iIndex)
   {
-    if (auto oReplacement = tryLoad(mGamePath / ASSET_REPLACEMENTS_PATH))
+    if (auto oPath = lookUpFile(*iIndex, lowercaseName))
     {
-      return *oReplacement;
+      return oPath;
     }
   }
 
@@ -176,12 +233,40 @@ std::optional<T> ResourceLoader::tryLoadReplacement(TryLoadFunc&& tryLoad) const
 }
 
 
+std::optional<fs::path>
+  ResourceLoader::findUnpackedFile(std::string_view name) const
+{
+  if (auto oPath = findModFile(name))
+  {
+    return oPath;
+  }
+
+  return lookUpFile(mModFileIndex.mTopLevelFiles, strings::toLowercase(name));
+}
+
+
+std::optional<fs::path>
+  ResourceLoader::findReplacement(std::string_view name) const
+{
+  if (auto oPath = findModFile(name))
+  {
+    return oPath;
+  }
+
+  return lookUpFile(
+    mModFileIndex.mAssetReplacements, strings::toLowercase(name));
+}
+
+
 std::optional<data::Image>
   ResourceLoader::tryLoadPngReplacement(std::string_view filename) const
 {
-  return tryLoadReplacement([filename](const fs::path& path) {
-    return loadPng((path / filename).u8string());
-  });
+  if (const auto oPath = findReplacement(filename))
+  {
+    return loadPng(oPath->u8string());
+  }
+
+  return {};
 }
 
 
@@ -324,6 +409,59 @@ ActorData ResourceLoader::loadActor(
 }
 
 
+bool ResourceLoader::hasHighResSpriteReplacements() const
+{
+  const auto isHighResReplacement = [&](const std::string& lowercaseName) {
+    static const auto spriteNameRegex =
+      std::regex{"^actor(\\d+)_frame(\\d+)\\.png$"};
+
+    std::smatch matches;
+    if (!std::regex_match(lowercaseName, matches, spriteNameRegex))
+    {
+      return false;
+    }
+
+    const auto id = static_cast<data::ActorID>(std::stoi(matches[1].str()));
+    const auto frame = std::stoul(matches[2].str());
+    if (!mActorImagePackage.hasActorInfo(id))
+    {
+      return false;
+    }
+
+    const auto& frames = mActorImagePackage.loadActorInfo(id).mFrames;
+    if (frame >= frames.size())
+    {
+      return false;
+    }
+
+    // The name might be present in several places, make sure to look at the
+    // file that would actually be used
+    const auto oPath = findReplacement(lowercaseName);
+    const auto oSize = oPath ? loadPngSize(oPath->u8string()) : std::nullopt;
+    if (!oSize)
+    {
+      return false;
+    }
+
+    const auto logicalSize = data::tilesToPixels(frames[frame].mSizeInTiles);
+    return oSize->width > logicalSize.width ||
+      oSize->height > logicalSize.height;
+  };
+
+  const auto containsHighResReplacement = [&](const FileIndex& index) {
+    return std::any_of(index.begin(), index.end(), [&](const auto& entry) {
+      return isHighResReplacement(entry.first);
+    });
+  };
+
+  return std::any_of(
+           mModFileIndex.mModDirectories.begin(),
+           mModFileIndex.mModDirectories.end(),
+           containsHighResReplacement) ||
+    containsHighResReplacement(mModFileIndex.mAssetReplacements);
+}
+
+
 data::Image ResourceLoader::loadBackdrop(std::string_view name) const
 {
   using namespace std::literals;
@@ -370,10 +508,10 @@ TileSet ResourceLoader::loadCZone(std::string_view name) const
     }
   }
 
-  const auto oReplacementImage =
-    tryLoadReplacement([name](const fs::path& path) {
-      return loadReplacementTilesetIfPresent(path, name);
-    });
+  const auto oReplacementName = replacementTilesetName(name);
+  const auto oReplacementImage = oReplacementName
+    ? tryLoadPngReplacement(*oReplacementName)
+    : std::nullopt;
 
   if (oReplacementImage)
   {
@@ -415,13 +553,9 @@ data::Movie ResourceLoader::loadMovie(std::string_view name) const
 {
   // We don't use tryLoadReplacement here, because we don't look for movies
   // in the top-level path.
-  for (auto iPath = mModPaths.rbegin(); iPath != mModPaths.rend(); ++iPath)
+  if (const auto oModdedFile = findModFile(name))
   {
-    const auto moddedFile = *iPath / fs::u8path(name);
-    if (fs::exists(moddedFile))
-    {
-      return assets::loadMovie(loadFile(moddedFile));
-    }
+    return assets::loadMovie(loadFile(*oModdedFile));
   }
 
   return assets::loadMovie(loadFile(mGamePath / fs::u8path(name)));
@@ -461,18 +595,23 @@ std::vector<std::filesystem::path>
   const auto expectedName =
     "sound"s + std::to_string(static_cast<int>(id) + 1) + ".wav";
 
+  // Only files which actually exist are returned, in order of priority
   auto result = std::vector<std::filesystem::path>{};
-  result.reserve(mModPaths.size());
 
-  std::transform(
-    mModPaths.rbegin(),
-    mModPaths.rend(),
-    std::back_inserter(result),
-    [&](const auto& path) { return path / expectedName; });
+  const auto& directories = mModFileIndex.mModDirectories;
+  for (auto iIndex = directories.rbegin(); iIndex != directories.rend();
+       ++iIndex)
+  {
+    if (auto oPath = lookUpFile(*iIndex, expectedName))
+    {
+      result.push_back(std::move(*oPath));
+    }
+  }
 
-  if (mEnableTopLevelMods)
+  if (
+    auto oPath = lookUpFile(mModFileIndex.mAssetReplacements, expectedName))
   {
-    result.push_back(mGamePath / ASSET_REPLACEMENTS_PATH / expectedName);
+    result.push_back(std::move(*oPath));
   }
 
   return result;
@@ -507,23 +646,9 @@ ScriptBundle ResourceLoader::loadScriptBundle(std::string_view fileName) const
 
 ByteBuffer ResourceLoader::file(std::string_view name) const
 {
-  // TODO: Eliminate duplication with tryLoadReplacement?
-  for (auto iPath = mModPaths.rbegin(); iPath != mModPaths.rend(); ++iPath)
+  if (const auto oUnpackedFilePath = findUnpackedFile(name))
   {
-    const auto unpackedFilePath = *iPath / fs::u8path(name);
-    if (fs::exists(unpackedFilePath))
-    {
-      return loadFile(unpackedFilePath);
-    }
-  }
-
-  if (mEnableTopLevelMods)
-  {
-    const auto unpackedFilePath = mGamePath / fs::u8path(name);
-    if (fs::exists(unpackedFilePath))
-    {
-      return loadFile(unpackedFilePath);
-    }
+    return loadFile(*oUnpackedFilePath);
   }
 
   return mFilePackage.file(name);
@@ -538,26 +663,7 @@ std::string ResourceLoader::fileAsText(std::string_view name) const
 
 bool ResourceLoader::hasFile(std::string_view name) const
 {
-  // TODO: Eliminate duplication with tryLoadReplacement?
-  for (auto iPath = mModPaths.rbegin(); iPath != mModPaths.rend(); ++iPath)
-  {
-    const auto unpackedFilePath = *iPath / fs::u8path(name);
-    if (fs::exists(unpackedFilePath))
-    {
-      return true;
-    }
-  }
-
-  if (mEnableTopLevelMods)
-  {
-    const auto unpackedFilePath = mGamePath / fs::u8path(name);
-    if (fs::exists(unpackedFilePath))
-    {
-      return true;
-    }
-  }
-
-  return mFilePackage.hasFile(name);
+  return findUnpackedFile(name) || mFilePackage.hasFile(name);
 }
 
 } // namespace rigel::assets
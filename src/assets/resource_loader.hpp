@@ -29,7 +29,9 @@
 #include "data/tile_attributes.hpp"
 
 #include <filesystem>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -91,6 +93,13 @@ public:
     return mActorImagePackage.drawIndexFor(id);
   }
 
+  /** True if any actor sprite is replaced by a higher-resolution image
+   *
+   * Only looks at the file listing and the PNG headers of the replacement
+   * images, so this is cheap enough to call before any sprites are loaded.
+   */
+  bool hasHighResSpriteReplacements() const;
+
   data::Image loadAntiPiracyImage() const;
 
   data::Image loadWideHudFrameImage() const;
@@ -114,14 +123,43 @@ public:
   std::string fileAsText(std::string_view name) const;
   bool hasFile(std::string_view name) const;
 
+  /** Re-scan mod directories for available files
+   *
+   * To avoid hitting the file system for each asset that could potentially
+   * be replaced by a mod, the contents of all mod directories are listed
+   * once on construction. If the contents of these directories might have
+   * changed afterwards, this function must be called to update the listing.
+   *
+   * Must not be called while other threads are using the ResourceLoader.
+   */
+  void rescanModFiles();
+
 private:
-  // The invoke_result of the TryLoadFunc is going to be a std::optional<T>,
-  // hence we need to unpack the underlying T via the optional's value_type
-  template <
-    typename TryLoadFunc,
-    typename T = typename std::
-      invoke_result_t<TryLoadFunc, const std::filesystem::path&>::value_type>
-  std::optional<T> tryLoadReplacement(TryLoadFunc&& tryLoad) const;
+  // Maps lower-case file names to full paths
+  using FileIndex = std::unordered_map<std::string, std::filesystem::path>;
+
+  struct ModFileIndex
+  {
+    // Same order as mModPaths
+    std::vector<FileIndex> mModDirectories;
+    FileIndex mTopLevelFiles;
+    FileIndex mAssetReplacements;
+  };
+
+  ModFileIndex scanModFiles() const;
+
+  /** Look for file in mod directories, in order of priority */
+  std::optional<std::filesystem::path>
+    findModFile(std::string_view name) const;
+
+  /** Like findModFile, but also considers top-level mods */
+  std::optional<std::filesystem::path>
+    findUnpackedFile(std::string_view name) const;
+
+  /** Like findModFile, but also considers asset_replacements */
+  std::optional<std::filesystem::path>
+    findReplacement(std::string_view name) const;
+
   std::optional<data::Image>
     tryLoadPngReplacement(std::string_view filename) const;
 
@@ -138,6 +176,7 @@ private:
   std::filesystem::path mGamePath;
   std::vector<std::filesystem::path> mModPaths;
   bool mEnableTopLevelMods;
+  ModFileIndex mModFileIndex;
 
   assets::CMPFilePackage mFilePackage;
   assets::ActorImagePackage mActorImagePackage;
@@ -43,9 +43,9 @@ void expandSingleRleWord(
   else
   {
     const auto numBytesToCopy = -marker;
-    for (int i = 0; i < numBytesToCopy; ++i)
+    for (const auto byte : reader.readBytes(numBytesToCopy))
     {
-      callback(reader.readU8());
+      callback(byte);
     }
   }
 }
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <iterator>
 #include <optional>
+#include <vector>
 
 
 /* Decoder for the Creative Voice File (VOC) format
@@ -302,10 +303,8 @@ void decodeAdpcmAudio(
   *outputIter++ = expand8BitSample(firstSample);
 
   AdpcmDecoderHelper decoder(firstSample);
-  for (auto i = 0u; i < encodedSize - 1; ++i)
+  for (const auto bitPack : reader.readBytes(encodedSize - 1))
   {
-    const auto bitPack = reader.readU8();
-
     switch (codec)
     {
       case AdpcmType::FourBits:
@@ -344,9 +343,9 @@ void decodeAudio(
   switch (codec)
   {
     case CodecType::Unsigned8BitPcm:
-      for (auto i = 0u; i < encodedSize; ++i)
+      for (const auto sample : reader.readBytes(encodedSize))
       {
-        *outputIter++ = expand8BitSample(reader.readU8());
+        *outputIter++ = expand8BitSample(sample);
       }
       break;
 
@@ -364,9 +363,10 @@ void decodeAudio(
       break;
 
     case CodecType::Signed16BitPcm:
-      for (auto i = 0u; i < encodedSize; ++i)
       {
-        *outputIter++ = reader.readS16();
+        std::vector<std::int16_t> samples(encodedSize);
+        reader.readS16Array(samples.data(), samples.size());
+        std::copy(samples.begin(), samples.end(), outputIter);
       }
       break;
   }
@@ -397,8 +397,7 @@ base::AudioBuffer decodeVoc(const ByteBuffer& data)
     }
     const auto chunkSize = reader.readU24();
 
-    LeStreamReader chunkReader(
-      reader.currentIter(), reader.currentIter() + chunkSize);
+    LeStreamReader chunkReader(reader.readBytes(chunkSize));
 
     switch (chunkType)
     {
@@ -459,8 +458,6 @@ base::AudioBuffer decodeVoc(const ByteBuffer& data)
         // Marker, text, and repeat chunks will just be skipped over.
         break;
     }
-
-    reader.skipBytes(chunkSize);
   }
 
   if (!sampleRate || decodedSamples.empty())
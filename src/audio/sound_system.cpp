@@ -22,6 +22,7 @@
 #include "audio/software_imf_player.hpp"
 #include "base/math_utils.hpp"
 #include "base/string_utils.hpp"
+#include "base/tracing.hpp"
 #include "sdl_utils/error.hpp"
 
 #include <loguru.hpp>
@@ -561,18 +562,15 @@ void SoundSystem::loadAllSounds(
     mpResources->file(assets::AUDIO_DATA_FILE));
 
   data::forEachSoundId([&](const auto id) {
+    // Only contains paths of files which exist
     for (const auto& replacementPath : mpResources->replacementSoundPaths(id))
     {
-      std::error_code ec;
-      if (std::filesystem::exists(replacementPath, ec))
+      const auto filename = replacementPath.u8string();
+      if (auto pMixChunk = Mix_LoadWAV(filename.c_str()))
       {
-        const auto filename = replacementPath.u8string();
-        if (auto pMixChunk = Mix_LoadWAV(filename.c_str()))
-        {
-          LOG_F(INFO, "Using replacement sound effect: %s", filename.c_str());
-          mSounds[idToIndex(id)] = LoadedSound{sdl_utils::wrap(pMixChunk)};
-          return;
-        }
+        LOG_F(INFO, "Using replacement sound effect: %s", filename.c_str());
+        mSounds[idToIndex(id)] = LoadedSound{sdl_utils::wrap(pMixChunk)};
+        return;
       }
     }
 
@@ -650,6 +648,9 @@ void SoundSystem::hookMusic() const
 {
   Mix_HookMusic(
     [](void* pUserData, Uint8* pOutBuffer, int bytesRequired) {
+      RIGEL_TRACE_THREAD_NAME("Audio thread");
+      RIGEL_TRACE_SCOPE("SoundSystem::renderMusic");
+
       auto pWrapper = static_cast<ImfPlayerWrapper*>(pUserData);
       pWrapper->render(pOutBuffer, bytesRequired);
     },
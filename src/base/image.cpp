@@ -16,6 +16,7 @@
 
 #include "image.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -73,6 +74,61 @@ Image Image::flipped() const
 }
 
 
+Image Image::downscaledByHalf() const
+{
+  const auto targetWidth = std::max(width() / 2, size_t{1});
+  const auto targetHeight = std::max(height() / 2, size_t{1});
+
+  PixelBuffer targetPixels;
+  targetPixels.reserve(targetWidth * targetHeight);
+
+  for (size_t y = 0; y < targetHeight; ++y)
+  {
+    const auto row0 = std::min(y * 2, height() - 1) * width();
+    const auto row1 = std::min(y * 2 + 1, height() - 1) * width();
+
+    for (size_t x = 0; x < targetWidth; ++x)
+    {
+      const auto col0 = std::min(x * 2, width() - 1);
+      const auto col1 = std::min(x * 2 + 1, width() - 1);
+
+      const Pixel* sourcePixels[] = {
+        &mPixels[row0 + col0],
+        &mPixels[row0 + col1],
+        &mPixels[row1 + col0],
+        &mPixels[row1 + col1]};
+
+      unsigned r = 0;
+      unsigned g = 0;
+      unsigned b = 0;
+      unsigned a = 0;
+      for (const auto pPixel : sourcePixels)
+      {
+        r += pPixel->r * pPixel->a;
+        g += pPixel->g * pPixel->a;
+        b += pPixel->b * pPixel->a;
+        a += pPixel->a;
+      }
+
+      if (a == 0)
+      {
+        targetPixels.push_back(Pixel{});
+      }
+      else
+      {
+        targetPixels.push_back(Pixel{
+          static_cast<std::uint8_t>((r + a / 2) / a),
+          static_cast<std::uint8_t>((g + a / 2) / a),
+          static_cast<std::uint8_t>((b + a / 2) / a),
+          static_cast<std::uint8_t>((a + 2) / 4)});
+      }
+    }
+  }
+
+  return Image{std::move(targetPixels), targetWidth, targetHeight};
+}
+
+
 void Image::insertImage(const size_t x, const size_t y, const Image& image)
 {
   insertImage(x, y, image.pixelData(), image.width());
@@ -103,4 +159,18 @@ void Image::insertImage(
 }
 
 
+std::vector<Image> createMipmaps(const Image& image, const int numLevels)
+{
+  std::vector<Image> levels;
+  levels.reserve(numLevels);
+
+  for (auto i = 0; i < numLevels; ++i)
+  {
+    levels.push_back((i == 0 ? image : levels.back()).downscaledByHalf());
+  }
+
+  return levels;
+}
+
+
 } // namespace rigel::data
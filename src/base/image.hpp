@@ -48,6 +48,15 @@ public:
 
   Image flipped() const;
 
+  /** Returns a copy of the image at half the width and height
+   *
+   * Each target pixel is the average of a 2x2 block of source pixels (box
+   * filter). Color channels are weighted by alpha, so that fully
+   * transparent pixels don't darken the edges of opaque areas.
+   * Dimensions are rounded down, but never go below 1.
+   */
+  Image downscaledByHalf() const;
+
   void insertImage(std::size_t x, std::size_t y, const Image& image);
   void insertImage(
     std::size_t x,
@@ -62,4 +71,13 @@ private:
 };
 
 
+/** Create a chain of successively halved versions of the given image
+ *
+ * Returns the given number of mipmap levels, not including the image
+ * itself. Each level is created from the previous one using
+ * Image::downscaledByHalf().
+ */
+std::vector<Image> createMipmaps(const Image& image, int numLevels);
+
+
 } // namespace rigel::data
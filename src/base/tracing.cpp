@@ -0,0 +1,223 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tracing.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace rigel::base::tracing
+{
+
+namespace
+{
+
+// Upper limit for the number of events recorded per thread, to avoid
+// unbounded memory growth when a session is left running for a long time.
+// At 10 scopes per frame and 240 FPS, this is enough for roughly 7 minutes.
+constexpr auto MAX_EVENTS_PER_THREAD = std::size_t{1'000'000};
+
+
+struct Event
+{
+  const char* mpName;
+  std::int64_t mStartUs;
+  std::int64_t mDurationUs;
+};
+
+
+struct ThreadBuffer
+{
+  explicit ThreadBuffer(const int id)
+    : mId(id)
+  {
+  }
+
+  std::mutex mMutex;
+  std::vector<Event> mEvents;
+  const char* mpName = nullptr;
+  int mId;
+};
+
+
+struct Session
+{
+  std::mutex mMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> mThreads;
+  std::string mOutputFilePath;
+  Clock::time_point mStartTime;
+  std::atomic<bool> mIsActive{false};
+};
+
+
+Session& session()
+{
+  static Session instance;
+  return instance;
+}
+
+
+ThreadBuffer& currentThreadBuffer()
+{
+  thread_local auto pBuffer = []() {
+    auto& s = session();
+    std::lock_guard lock{s.mMutex};
+
+    auto pNewBuffer =
+      std::make_shared<ThreadBuffer>(static_cast<int>(s.mThreads.size()) + 1);
+    s.mThreads.push_back(pNewBuffer);
+    return pNewBuffer;
+  }();
+
+  return *pBuffer;
+}
+
+
+std::int64_t microsecondsSinceStart(const Clock::time_point time)
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(time - session().mStartTime).count();
+}
+
+
+void writeEscaped(std::ostream& stream, const char* text)
+{
+  for (auto pChar = text; *pChar; ++pChar)
+  {
+    if (*pChar == '"' || *pChar == '\\')
+    {
+      stream << '\\';
+    }
+
+    stream << *pChar;
+  }
+}
+
+} // namespace
+
+
+void beginSession(const std::string& outputFilePath)
+{
+  auto& s = session();
+  std::lock_guard lock{s.mMutex};
+
+  for (auto& pThread : s.mThreads)
+  {
+    std::lock_guard threadLock{pThread->mMutex};
+    pThread->mEvents.clear();
+  }
+
+  s.mOutputFilePath = outputFilePath;
+  s.mStartTime = Clock::now();
+  s.mIsActive.store(true, std::memory_order_release);
+}
+
+
+void endSession()
+{
+  auto& s = session();
+  if (!s.mIsActive.exchange(false, std::memory_order_acq_rel))
+  {
+    return;
+  }
+
+  std::lock_guard lock{s.mMutex};
+
+  std::ofstream file(s.mOutputFilePath);
+  if (!file.is_open())
+  {
+    return;
+  }
+
+  file << "{\"traceEvents\":[\n";
+
+  auto isFirst = true;
+  auto beginEntry = [&]() {
+    if (!isFirst)
+    {
+      file << ",\n";
+    }
+    isFirst = false;
+  };
+
+  for (auto& pThread : s.mThreads)
+  {
+    std::lock_guard threadLock{pThread->mMutex};
+
+    if (pThread->mpName)
+    {
+      beginEntry();
+      file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)"
+           << pThread->mId << R"(,"args":{"name":")";
+      writeEscaped(file, pThread->mpName);
+      file << "\"}}";
+    }
+
+    for (const auto& event : pThread->mEvents)
+    {
+      beginEntry();
+      file << R"({"name":")";
+      writeEscaped(file, event.mpName);
+      file << R"(","ph":"X","pid":1,"tid":)" << pThread->mId
+           << ",\"ts\":" << event.mStartUs << ",\"dur\":" << event.mDurationUs
+           << '}';
+    }
+
+    pThread->mEvents.clear();
+  }
+
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+void setCurrentThreadName(const char* name)
+{
+  auto& buffer = currentThreadBuffer();
+  std::lock_guard lock{buffer.mMutex};
+  buffer.mpName = name;
+}
+
+
+void recordEvent(
+  const char* name,
+  const Clock::time_point start,
+  const Clock::time_point end)
+{
+  if (!session().mIsActive.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  using namespace std::chrono;
+
+  auto& buffer = currentThreadBuffer();
+  std::lock_guard lock{buffer.mMutex};
+
+  if (buffer.mEvents.size() < MAX_EVENTS_PER_THREAD)
+  {
+    buffer.mEvents.push_back(Event{
+      name,
+      microsecondsSinceStart(start),
+      duration_cast<microseconds>(end - start).count()});
+  }
+}
+
+} // namespace rigel::base::tracing
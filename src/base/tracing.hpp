@@ -0,0 +1,110 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/clock.hpp"
+
+#include <string>
+
+
+/** Lightweight scope tracing, exported as Chrome trace event JSON
+ *
+ * When the engine is built with RIGEL_ENABLE_TRACING (CMake option
+ * ENABLE_TRACING), the RIGEL_TRACE_SCOPE/RIGEL_TRACE_FUNCTION macros record
+ * the start time and duration of the enclosing scope, together with the
+ * calling thread. Events are collected in memory while a session is active,
+ * and written out when the session ends. The resulting file can be opened
+ * with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Nested scopes don't need any special handling: The trace viewer derives
+ * the nesting from the time stamps of events recorded on the same thread.
+ *
+ * Without RIGEL_ENABLE_TRACING, all macros expand to nothing, so there is
+ * no overhead at all in regular builds.
+ *
+ * The name given to the macros must be a string literal (or otherwise have
+ * static storage duration), since only the pointer is stored.
+ */
+namespace rigel::base::tracing
+{
+
+/** Start recording trace events
+ *
+ * Events will be written to the given file once endSession() is called.
+ * Any events recorded by a previous session which hasn't been ended are
+ * discarded.
+ */
+void beginSession(const std::string& outputFilePath);
+
+/** Stop recording and write all recorded events to the output file */
+void endSession();
+
+/** Give the calling thread a name to be shown in the trace viewer */
+void setCurrentThreadName(const char* name);
+
+void recordEvent(
+  const char* name,
+  Clock::time_point start,
+  Clock::time_point end);
+
+
+class ScopedEvent
+{
+public:
+  explicit ScopedEvent(const char* name)
+    : mpName(name)
+    , mStart(Clock::now())
+  {
+  }
+
+  ~ScopedEvent() { recordEvent(mpName, mStart, Clock::now()); }
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+  const char* mpName;
+  Clock::time_point mStart;
+};
+
+} // namespace rigel::base::tracing
+
+
+#if defined(RIGEL_ENABLE_TRACING) && RIGEL_ENABLE_TRACING
+
+  #define RIGEL_TRACE_CONCAT_IMPL(a, b) a##b
+  #define RIGEL_TRACE_CONCAT(a, b) RIGEL_TRACE_CONCAT_IMPL(a, b)
+
+  #define RIGEL_TRACE_SCOPE(name)                                              \
+    ::rigel::base::tracing::ScopedEvent RIGEL_TRACE_CONCAT(                    \
+      rigelTraceScope, __LINE__)                                               \
+    {                                                                          \
+      name                                                                     \
+    }
+
+  #define RIGEL_TRACE_FUNCTION() RIGEL_TRACE_SCOPE(__func__)
+
+  #define RIGEL_TRACE_THREAD_NAME(name)                                        \
+    ::rigel::base::tracing::setCurrentThreadName(name)
+
+#else
+
+  #define RIGEL_TRACE_SCOPE(name) static_cast<void>(0)
+  #define RIGEL_TRACE_FUNCTION() static_cast<void>(0)
+  #define RIGEL_TRACE_THREAD_NAME(name) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,146 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "worker_thread.hpp"
+
+#include "base/tracing.hpp"
+
+#include <utility>
+
+
+namespace rigel::base
+{
+
+#ifdef __EMSCRIPTEN__
+
+WorkerThread::WorkerThread(const char* name)
+  : mpName(name)
+{
+}
+
+
+WorkerThread::~WorkerThread() = default;
+
+
+void WorkerThread::post(Task task)
+{
+  task();
+}
+
+
+void WorkerThread::waitUntilIdle()
+{
+}
+
+
+void WorkerThread::waitUntilPendingCountBelow(std::size_t)
+{
+}
+
+
+std::size_t WorkerThread::pendingTaskCount() const
+{
+  return 0;
+}
+
+#else
+
+WorkerThread::WorkerThread(const char* name)
+  : mpName(name)
+  , mThread([this]() { run(); })
+{
+}
+
+
+WorkerThread::~WorkerThread()
+{
+  {
+    std::lock_guard lock{mMutex};
+    mShouldStop = true;
+  }
+
+  mTaskAvailable.notify_one();
+  mThread.join();
+}
+
+
+void WorkerThread::post(Task task)
+{
+  {
+    std::lock_guard lock{mMutex};
+    mTasks.push_back(std::move(task));
+  }
+
+  mTaskAvailable.notify_one();
+}
+
+
+void WorkerThread::waitUntilIdle()
+{
+  waitUntilPendingCountBelow(1);
+}
+
+
+void WorkerThread::waitUntilPendingCountBelow(const std::size_t count)
+{
+  std::unique_lock lock{mMutex};
+  mTaskFinished.wait(lock, [&]() {
+    return mTasks.size() + mNumTasksInProgress < count;
+  });
+}
+
+
+std::size_t WorkerThread::pendingTaskCount() const
+{
+  std::lock_guard lock{mMutex};
+  return mTasks.size() + mNumTasksInProgress;
+}
+
+
+void WorkerThread::run()
+{
+  RIGEL_TRACE_THREAD_NAME(mpName);
+
+  std::unique_lock lock{mMutex};
+
+  for (;;)
+  {
+    mTaskAvailable.wait(
+      lock, [this]() { return mShouldStop || !mTasks.empty(); });
+
+    if (mTasks.empty())
+    {
+      // Only get here when stopping, and all remaining tasks are done
+      break;
+    }
+
+    auto task = std::move(mTasks.front());
+    mTasks.pop_front();
+    ++mNumTasksInProgress;
+
+    lock.unlock();
+    task();
+    task = {};
+    lock.lock();
+
+    --mNumTasksInProgress;
+    mTaskFinished.notify_all();
+  }
+}
+
+#endif
+
+} // namespace rigel::base
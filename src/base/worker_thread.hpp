@@ -0,0 +1,82 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace rigel::base
+{
+
+/** Runs tasks on a dedicated background thread
+ *
+ * Tasks are executed one after another, in the order they were posted.
+ * This is meant for work that shouldn't block the main thread, like
+ * encoding images or writing files. Tasks are responsible for handling
+ * their own errors, they must not throw.
+ *
+ * On platforms without thread support (Emscripten), tasks are executed
+ * immediately on the calling thread instead.
+ *
+ * Destroying the worker runs all remaining tasks before joining the thread.
+ */
+class WorkerThread
+{
+public:
+  using Task = std::function<void()>;
+
+  /** The name must be a string literal, it's used for tracing */
+  explicit WorkerThread(const char* name);
+  ~WorkerThread();
+
+  WorkerThread(const WorkerThread&) = delete;
+  WorkerThread& operator=(const WorkerThread&) = delete;
+
+  void post(Task task);
+
+  /** Block until all tasks posted so far have finished */
+  void waitUntilIdle();
+
+  /** Block until fewer than the given number of tasks are pending
+   *
+   * Can be used to put a bound on the number of queued tasks, by calling it
+   * before post().
+   */
+  void waitUntilPendingCountBelow(std::size_t count);
+
+  /** Number of tasks that have been posted but haven't finished yet */
+  std::size_t pendingTaskCount() const;
+
+private:
+  void run();
+
+  mutable std::mutex mMutex;
+  std::condition_variable mTaskAvailable;
+  std::condition_variable mTaskFinished;
+  std::deque<Task> mTasks;
+  std::size_t mNumTasksInProgress = 0;
+  bool mShouldStop = false;
+  const char* mpName;
+  std::thread mThread;
+};
+
+} // namespace rigel::base
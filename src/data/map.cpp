@@ -30,6 +30,73 @@ namespace rigel::data::map
 using namespace std;
 
 
+namespace
+{
+
+constexpr auto NUM_EDGES = 4;
+constexpr auto BITS_PER_WORD = 64;
+
+
+std::size_t wordsForBits(const std::size_t numBits)
+{
+  return (numBits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+
+/** Returns a mask with bits [first, last] set, both in range [0, 63] */
+std::uint64_t bitRange(const int first, const int last)
+{
+  const auto upTo = last == BITS_PER_WORD - 1
+    ? ~std::uint64_t{0}
+    : (std::uint64_t{1} << (last + 1)) - 1;
+  return upTo & (~std::uint64_t{0} << first);
+}
+
+
+bool anyBitSet(
+  const std::vector<std::uint64_t>& words,
+  const std::size_t offset,
+  const int first,
+  const int last)
+{
+  const auto firstWord = first / BITS_PER_WORD;
+  const auto lastWord = last / BITS_PER_WORD;
+
+  for (auto word = firstWord; word <= lastWord; ++word)
+  {
+    const auto firstBit = word == firstWord ? first % BITS_PER_WORD : 0;
+    const auto lastBit =
+      word == lastWord ? last % BITS_PER_WORD : BITS_PER_WORD - 1;
+
+    if (words[offset + word] & bitRange(firstBit, lastBit))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void assignBit(
+  std::vector<std::uint64_t>& words,
+  const std::size_t index,
+  const bool value)
+{
+  const auto bit = std::uint64_t{1} << (index % BITS_PER_WORD);
+  if (value)
+  {
+    words[index / BITS_PER_WORD] |= bit;
+  }
+  else
+  {
+    words[index / BITS_PER_WORD] &= ~bit;
+  }
+}
+
+} // namespace
+
+
 Map::Map(
   const int widthInTiles,
   const int heightInTiles,
@@ -40,9 +107,29 @@ Map::Map(
   , mWidthInTiles(static_cast<size_t>(widthInTiles))
   , mHeightInTiles(static_cast<size_t>(heightInTiles))
   , mAttributes(std::move(attributes))
+  , mMaskWordsPerRow(wordsForBits(mWidthInTiles))
+  , mMaskWordsPerColumn(wordsForBits(mHeightInTiles))
 {
   assert(widthInTiles >= 0);
   assert(heightInTiles >= 0);
+
+  for (auto& masks : mRowMasks)
+  {
+    masks.resize(mMaskWordsPerRow * mHeightInTiles);
+  }
+
+  for (auto& masks : mColumnMasks)
+  {
+    masks.resize(mMaskWordsPerColumn * mWidthInTiles);
+  }
+
+  for (auto y = 0; y < heightInTiles; ++y)
+  {
+    for (auto x = 0; x < widthInTiles; ++x)
+    {
+      updateCollisionMasks(x, y);
+    }
+  }
 }
 
 
@@ -59,6 +146,7 @@ void Map::setTileAt(const int layer, const int x, const int y, TileIndex index)
     throw invalid_argument("Tile index too large for tile set");
   }
   tileRefAt(layer, x, y) = index;
+  updateCollisionMasks(x, y);
 }
 
 
@@ -138,6 +226,103 @@ CollisionData Map::collisionData(const int x, const int y) const
 }
 
 
+bool Map::hasSolidEdgeInRow(
+  const int startX,
+  const int endX,
+  const int y,
+  const SolidEdge edge) const
+{
+  if (startX > endX)
+  {
+    return false;
+  }
+
+  if (startX < 0 || static_cast<std::size_t>(endX) >= mWidthInTiles)
+  {
+    // Left/right edge of the map are always solid, see collisionData()
+    return true;
+  }
+
+  if (static_cast<std::size_t>(y) >= mHeightInTiles)
+  {
+    return false;
+  }
+
+  const auto offset = static_cast<std::size_t>(y) * mMaskWordsPerRow;
+  for (auto i = 0; i < NUM_EDGES; ++i)
+  {
+    if (
+      (edge.mFlagsBitPack & (1 << i)) &&
+      anyBitSet(mRowMasks[i], offset, startX, endX))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+bool Map::hasSolidEdgeInColumn(
+  int startY,
+  int endY,
+  const int x,
+  const SolidEdge edge) const
+{
+  if (startY > endY)
+  {
+    return false;
+  }
+
+  if (static_cast<std::size_t>(x) >= mWidthInTiles)
+  {
+    // Left/right edge of the map are always solid, see collisionData()
+    return true;
+  }
+
+  // Bottom/top edge of the map are never solid
+  startY = std::max(startY, 0);
+  endY = std::min(endY, static_cast<int>(mHeightInTiles) - 1);
+  if (startY > endY)
+  {
+    return false;
+  }
+
+  const auto offset = static_cast<std::size_t>(x) * mMaskWordsPerColumn;
+  for (auto i = 0; i < NUM_EDGES; ++i)
+  {
+    if (
+      (edge.mFlagsBitPack & (1 << i)) &&
+      anyBitSet(mColumnMasks[i], offset, startY, endY))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void Map::updateCollisionMasks(const int x, const int y)
+{
+  const auto data = collisionData(x, y);
+  const auto rowBitIndex =
+    static_cast<std::size_t>(y) * mMaskWordsPerRow * BITS_PER_WORD +
+    static_cast<std::size_t>(x);
+  const auto columnBitIndex =
+    static_cast<std::size_t>(x) * mMaskWordsPerColumn * BITS_PER_WORD +
+    static_cast<std::size_t>(y);
+
+  for (auto i = 0; i < NUM_EDGES; ++i)
+  {
+    const auto isSolid =
+      data.isSolidOn(SolidEdge{static_cast<std::uint8_t>(1 << i)});
+    assignBit(mRowMasks[i], rowBitIndex, isSolid);
+    assignBit(mColumnMasks[i], columnBitIndex, isSolid);
+  }
+}
+
+
 const map::TileIndex&
   Map::tileRefAt(const int layerS, const int xS, const int yS) const
 {
@@ -22,6 +22,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -69,10 +70,27 @@ public:
 
   CollisionData collisionData(int x, int y) const;
 
+  /** Check if any tile in the given row span is solid on the given edge
+   *
+   * Equivalent to checking collisionData(x, y).isSolidOn(edge) for each x in
+   * [startX, endX], but works on precomputed bit masks, testing up to 64
+   * tiles at once.
+   */
+  bool hasSolidEdgeInRow(int startX, int endX, int y, SolidEdge edge) const;
+
+  /** Like hasSolidEdgeInRow(), but for the column span [startY, endY] */
+  bool
+    hasSolidEdgeInColumn(int startY, int endY, int x, SolidEdge edge) const;
+
 private:
+  using MaskWord = std::uint64_t;
+  using EdgeMasks = std::array<std::vector<MaskWord>, 4>;
+
   const TileIndex& tileRefAt(int layer, int x, int y) const;
   TileIndex& tileRefAt(int layer, int x, int y);
 
+  void updateCollisionMasks(int x, int y);
+
 private:
   using TileArray = std::vector<TileIndex>;
   std::array<TileArray, 2> mLayers;
@@ -81,6 +99,14 @@ private:
   std::size_t mHeightInTiles;
 
   TileAttributeDict mAttributes;
+
+  // One bit per tile and solid edge, indicating whether collisionData()
+  // for that tile is solid on the edge. Stored twice, once row by row for
+  // horizontal span tests, and once column by column for vertical ones.
+  EdgeMasks mRowMasks;
+  EdgeMasks mColumnMasks;
+  std::size_t mMaskWordsPerRow = 0;
+  std::size_t mMaskWordsPerColumn = 0;
 };
 
 
@@ -97,6 +123,12 @@ struct LevelData
   Image mBackdropImage;
   std::optional<Image> mSecondaryBackdropImage;
 
+  // Names of the files the images above were loaded from. These identify
+  // the images, e.g. for sharing textures between instances of a level.
+  std::string mTileSetName;
+  std::string mBackdropName;
+  std::string mSecondaryBackdropName;
+
   data::map::Map mMap;
   std::vector<Actor> mActors;
   base::Vec2 mPlayerSpawnPosition;
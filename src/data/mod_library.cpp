@@ -17,6 +17,7 @@
 #include "mod_library.hpp"
 
 #include "base/container_utils.hpp"
+#include "base/defer.hpp"
 
 #include <loguru.hpp>
 
@@ -88,6 +89,13 @@ void ModLibrary::rescan()
 
   LOG_SCOPE_FUNCTION(INFO);
 
+  auto notifyHook = base::defer([this]() {
+    if (mRescanHook)
+    {
+      mRescanHook();
+    }
+  });
+
   // List all sub-directories of the "mods" directory. Each one is considered
   // a mod.
   LOG_F(INFO, "Listing mod directories");
@@ -228,6 +236,12 @@ void ModLibrary::rescan()
 }
 
 
+void ModLibrary::setRescanHook(std::function<void()> hook)
+{
+  mRescanHook = std::move(hook);
+}
+
+
 std::vector<std::filesystem::path> ModLibrary::enabledModPaths() const
 {
   // TODO: Maybe express this in a nicer way using ranges?
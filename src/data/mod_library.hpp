@@ -17,6 +17,7 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -59,6 +60,13 @@ public:
   void updateGamePath(std::filesystem::path gamePath);
   void rescan();
 
+  /** Set function to be invoked after each rescan()
+   *
+   * Allows the game to refresh anything that depends on the contents of
+   * the mod directories, like the resource loader's file index.
+   */
+  void setRescanHook(std::function<void()> hook);
+
   [[nodiscard]] std::vector<std::filesystem::path> enabledModPaths() const;
   [[nodiscard]] const std::string& modDirName(int index) const;
 
@@ -73,6 +81,7 @@ private:
   std::vector<std::string> mAvailableMods;
   std::vector<ModStatus> mModSelection;
   std::filesystem::path mGamePath;
+  std::function<void()> mRescanHook;
   bool mHasChanged = false;
 };
 
@@ -86,24 +86,16 @@ bool CollisionChecker::testHorizontalSpan(
   const int y,
   const SolidEdge edge) const
 {
+  // The static geometry test is a handful of bit mask operations, so we do
+  // it first. Solid bodies need to be checked one by one.
+  if (mpMap->hasSolidEdgeInRow(startX, endX, y, edge))
   {
-    const auto width = endX - startX + 1;
-    const auto bboxForSolidBodyTest = BoundingBox{{startX, y}, {width, 1}};
-    if (testSolidBodyCollision(bboxForSolidBodyTest))
-    {
-      return true;
-    }
+    return true;
   }
 
-  for (int x = startX; x <= endX; ++x)
-  {
-    if (mpMap->collisionData(x, y).isSolidOn(edge))
-    {
-      return true;
-    }
-  }
-
-  return false;
+  const auto width = endX - startX + 1;
+  const auto bboxForSolidBodyTest = BoundingBox{{startX, y}, {width, 1}};
+  return testSolidBodyCollision(bboxForSolidBodyTest);
 }
 
 
@@ -113,24 +105,14 @@ bool CollisionChecker::testVerticalSpan(
   const int x,
   const SolidEdge edge) const
 {
+  if (mpMap->hasSolidEdgeInColumn(startY, endY, x, edge))
   {
-    const auto height = endY - startY + 1;
-    const auto bboxForSolidBodyTest = BoundingBox{{x, startY}, {1, height}};
-    if (testSolidBodyCollision(bboxForSolidBodyTest))
-    {
-      return true;
-    }
-  }
-
-  for (int y = startY; y <= endY; ++y)
-  {
-    if (mpMap->collisionData(x, y).isSolidOn(edge))
-    {
-      return true;
-    }
+    return true;
   }
 
-  return false;
+  const auto height = endY - startY + 1;
+  const auto bboxForSolidBodyTest = BoundingBox{{x, startY}, {1, height}};
+  return testSolidBodyCollision(bboxForSolidBodyTest);
 }
 
 
@@ -21,6 +21,9 @@
 #include "engine/entity_tools.hpp"
 #include "engine/physical_components.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 
 namespace rigel::engine
 {
@@ -31,6 +34,36 @@ using namespace components;
 namespace
 {
 
+// Size of a spatial hash cell, in tiles. This should be in the same ballpark
+// as the viewport size, so that an update only needs to look at a handful
+// of cells.
+constexpr auto CELL_SIZE = 32;
+
+
+int toCellCoordinate(const int tileCoordinate)
+{
+  // Round towards negative infinity, entities might be positioned at
+  // negative coordinates
+  return tileCoordinate >= 0 ? tileCoordinate / CELL_SIZE
+                             : (tileCoordinate - (CELL_SIZE - 1)) / CELL_SIZE;
+}
+
+
+bool hasSpatialComponents(entityx::Entity entity)
+{
+  return entity.valid() && entity.has_component<WorldPosition>() &&
+    entity.has_component<BoundingBox>();
+}
+
+
+BoundingBox worldSpaceBoundsOf(entityx::Entity entity)
+{
+  return toWorldSpace(
+    *entity.component<const BoundingBox>(),
+    *entity.component<const WorldPosition>());
+}
+
+
 bool determineActiveState(entityx::Entity entity, const bool inActiveRegion)
 {
   using Policy = ActivationSettings::Policy;
@@ -98,4 +131,289 @@ void markActiveEntities(
   });
 }
 
+
+
+EntityActivationSystem::EntityActivationSystem(
+  entityx::EntityManager& entities,
+  entityx::EventManager& eventManager)
+{
+  invalidate(entities);
+
+  eventManager.subscribe<entityx::EntityDestroyedEvent>(*this);
+  eventManager.subscribe<entityx::ComponentAddedEvent<WorldPosition>>(*this);
+  eventManager.subscribe<entityx::ComponentAddedEvent<BoundingBox>>(*this);
+  eventManager.subscribe<entityx::ComponentAddedEvent<ActivationSettings>>(
+    *this);
+  eventManager.subscribe<entityx::ComponentAddedEvent<Active>>(*this);
+}
+
+
+void EntityActivationSystem::update(
+  entityx::EntityManager& es,
+  const base::Vec2& cameraPosition,
+  const base::Size& viewportSize)
+{
+  const BoundingBox activeRegionBox{cameraPosition, viewportSize};
+
+  // Step 1: Newly added or otherwise changed entities are woken up, so that
+  // they are evaluated in step 3.
+  for (const auto entity : mPendingEntities)
+  {
+    if (hasSpatialComponents(entity))
+    {
+      wakeUp(entity);
+    }
+    else if (entity.valid())
+    {
+      stopTracking(entity);
+    }
+  }
+  mPendingEntities.clear();
+
+  // Step 2: Wake up dormant entities which have entered the active region.
+  // Since dormant entities don't move, we only need to look at the cells
+  // overlapping the active region.
+  mCandidatesScratch.clear();
+  forEachCell(activeRegionBox, [&](std::vector<entityx::Entity>& cell) {
+    mCandidatesScratch.insert(
+      mCandidatesScratch.end(), cell.begin(), cell.end());
+  });
+
+  for (const auto entity : mCandidatesScratch)
+  {
+    // An entity can be in multiple cells, in which case it might have been
+    // woken up already.
+    if (stateFor(entity).mStatus != Status::Dormant)
+    {
+      continue;
+    }
+
+    if (!hasSpatialComponents(entity))
+    {
+      stopTracking(entity);
+      continue;
+    }
+
+    if (worldSpaceBoundsOf(entity).intersects(activeRegionBox))
+    {
+      wakeUp(entity);
+    }
+  }
+
+  // Step 3: Evaluate all awake entities. This is the same logic as in
+  // markActiveEntities(). Entities which turn inactive go to sleep.
+  for (std::size_t i = 0; i < mAwakeEntities.size();)
+  {
+    const auto entity = mAwakeEntities[i];
+
+    if (!hasSpatialComponents(entity))
+    {
+      // Like markActiveEntities(), leave the entity's Active tag untouched
+      // if it's lacking a position or bounding box
+      stopTracking(entity);
+      continue;
+    }
+
+    const auto worldSpaceBbox = worldSpaceBoundsOf(entity);
+    const auto inActiveRegion = worldSpaceBbox.intersects(activeRegionBox);
+    const auto active = determineActiveState(entity, inActiveRegion);
+    setTag<Active>(entity, active);
+
+    if (active)
+    {
+      entity.component<Active>()->mIsOnScreen = inActiveRegion;
+      ++i;
+    }
+    else
+    {
+      // This swaps the last awake entity into slot i, so we must not
+      // advance i here.
+      putToSleep(entity, worldSpaceBbox);
+    }
+  }
+}
+
+
+void EntityActivationSystem::invalidate(entityx::EntityManager& es)
+{
+  es.each<WorldPosition, BoundingBox>(
+    [this](entityx::Entity entity, const WorldPosition&, const BoundingBox&) {
+      markPending(entity);
+    });
+}
+
+
+void EntityActivationSystem::receive(const entityx::EntityDestroyedEvent& event)
+{
+  stopTracking(event.entity);
+}
+
+
+void EntityActivationSystem::receive(
+  const entityx::ComponentAddedEvent<WorldPosition>& event)
+{
+  markPending(event.entity);
+}
+
+
+void EntityActivationSystem::receive(
+  const entityx::ComponentAddedEvent<BoundingBox>& event)
+{
+  markPending(event.entity);
+}
+
+
+void EntityActivationSystem::receive(
+  const entityx::ComponentAddedEvent<ActivationSettings>& event)
+{
+  markPending(event.entity);
+}
+
+
+void EntityActivationSystem::receive(
+  const entityx::ComponentAddedEvent<Active>& event)
+{
+  markPending(event.entity);
+}
+
+
+auto EntityActivationSystem::stateFor(const entityx::Entity entity)
+  -> EntityState&
+{
+  const auto index = entity.id().index();
+  if (index >= mStates.size())
+  {
+    mStates.resize(index + 1);
+  }
+
+  auto& state = mStates[index];
+  if (state.mEntity != entity)
+  {
+    // The slot belongs to a previous entity which has been destroyed (and
+    // was thus already removed from all lists), or is unused so far
+    state = EntityState{};
+    state.mEntity = entity;
+  }
+
+  return state;
+}
+
+
+void EntityActivationSystem::markPending(const entityx::Entity entity)
+{
+  if (stateFor(entity).mStatus != Status::Awake)
+  {
+    mPendingEntities.push_back(entity);
+  }
+}
+
+
+void EntityActivationSystem::wakeUp(const entityx::Entity entity)
+{
+  auto& state = stateFor(entity);
+  if (state.mStatus == Status::Awake)
+  {
+    return;
+  }
+
+  if (state.mStatus == Status::Dormant)
+  {
+    removeFromCells(state);
+  }
+
+  state.mStatus = Status::Awake;
+  state.mAwakeSlot = static_cast<std::uint32_t>(mAwakeEntities.size());
+  mAwakeEntities.push_back(entity);
+}
+
+
+void EntityActivationSystem::putToSleep(
+  const entityx::Entity entity,
+  const BoundingBox& bbox)
+{
+  auto& state = stateFor(entity);
+  assert(state.mStatus == Status::Awake);
+
+  removeFromAwakeList(state);
+
+  state.mStatus = Status::Dormant;
+  state.mDormantBounds = bbox;
+  forEachCell(bbox, [&](std::vector<entityx::Entity>& cell) {
+    cell.push_back(entity);
+  });
+}
+
+
+void EntityActivationSystem::stopTracking(const entityx::Entity entity)
+{
+  auto& state = stateFor(entity);
+
+  if (state.mStatus == Status::Awake)
+  {
+    removeFromAwakeList(state);
+  }
+  else if (state.mStatus == Status::Dormant)
+  {
+    removeFromCells(state);
+  }
+
+  state.mStatus = Status::Untracked;
+}
+
+
+void EntityActivationSystem::removeFromAwakeList(EntityState& state)
+{
+  const auto slot = state.mAwakeSlot;
+  const auto lastEntity = mAwakeEntities.back();
+
+  mAwakeEntities[slot] = lastEntity;
+  mAwakeEntities.pop_back();
+
+  if (lastEntity != state.mEntity)
+  {
+    stateFor(lastEntity).mAwakeSlot = slot;
+  }
+}
+
+
+void EntityActivationSystem::removeFromCells(EntityState& state)
+{
+  const auto entity = state.mEntity;
+  forEachCell(state.mDormantBounds, [&](std::vector<entityx::Entity>& cell) {
+    const auto it = std::find(cell.begin(), cell.end(), entity);
+    if (it != cell.end())
+    {
+      *it = cell.back();
+      cell.pop_back();
+    }
+  });
+}
+
+
+template <typename Callback>
+void EntityActivationSystem::forEachCell(
+  const BoundingBox& bbox,
+  Callback&& callback)
+{
+  if (bbox.size.width <= 0 || bbox.size.height <= 0)
+  {
+    return;
+  }
+
+  const auto firstCellX = toCellCoordinate(bbox.left());
+  const auto lastCellX = toCellCoordinate(bbox.right());
+  const auto firstCellY = toCellCoordinate(bbox.top());
+  const auto lastCellY = toCellCoordinate(bbox.bottom());
+
+  for (auto cellY = firstCellY; cellY <= lastCellY; ++cellY)
+  {
+    for (auto cellX = firstCellX; cellX <= lastCellX; ++cellX)
+    {
+      const auto key = (CellKey{static_cast<std::uint32_t>(cellY)} << 32) |
+        CellKey{static_cast<std::uint32_t>(cellX)};
+      callback(mDormantCells[key]);
+    }
+  }
+}
+
 } // namespace rigel::engine
@@ -18,18 +18,105 @@
 
 #include "base/spatial_types.hpp"
 #include "base/warnings.hpp"
+#include "engine/base_components.hpp"
 
 RIGEL_DISABLE_WARNINGS
 #include <entityx/entityx.h>
 RIGEL_RESTORE_WARNINGS
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 
 namespace rigel::engine
 {
 
+/** Assigns or removes the Active tag for all entities
+ *
+ * This visits every entity with a position and bounding box. It's the
+ * reference implementation for EntityActivationSystem, which produces the
+ * same results but only needs to look at a fraction of the entities.
+ */
 void markActiveEntities(
   entityx::EntityManager& es,
   const base::Vec2& cameraPosition,
   const base::Size& viewportSize);
 
-}
+
+/** Incremental version of markActiveEntities()
+ *
+ * Produces exactly the same Active tags as markActiveEntities(), but avoids
+ * visiting all entities on every update. Active entities are kept in a dense
+ * list and re-evaluated each update, since they can move or leave the active
+ * region. Inactive ("dormant") entities are put into a coarse spatial hash,
+ * and only the buckets overlapping the active region are checked.
+ *
+ * This relies on inactive entities not moving: All systems which change an
+ * entity's position only operate on active entities. Newly created entities,
+ * and entities which get a position, bounding box, activation settings or
+ * Active tag assigned, are picked up via entityx events and re-evaluated on
+ * the next update. If an inactive entity's position is changed directly,
+ * call invalidate() afterwards.
+ */
+class EntityActivationSystem : public entityx::Receiver<EntityActivationSystem>
+{
+public:
+  EntityActivationSystem(
+    entityx::EntityManager& entities,
+    entityx::EventManager& eventManager);
+
+  void update(
+    entityx::EntityManager& es,
+    const base::Vec2& cameraPosition,
+    const base::Size& viewportSize);
+
+  /** Re-evaluate all entities on the next update */
+  void invalidate(entityx::EntityManager& es);
+
+  void receive(const entityx::EntityDestroyedEvent& event);
+  void receive(
+    const entityx::ComponentAddedEvent<components::WorldPosition>& event);
+  void receive(
+    const entityx::ComponentAddedEvent<components::BoundingBox>& event);
+  void receive(
+    const entityx::ComponentAddedEvent<components::ActivationSettings>& event);
+  void receive(const entityx::ComponentAddedEvent<components::Active>& event);
+
+private:
+  enum class Status : std::uint8_t
+  {
+    Untracked,
+    Awake,
+    Dormant
+  };
+
+  struct EntityState
+  {
+    entityx::Entity mEntity;
+    components::BoundingBox mDormantBounds;
+    std::uint32_t mAwakeSlot = 0;
+    Status mStatus = Status::Untracked;
+  };
+
+  using CellKey = std::uint64_t;
+
+  EntityState& stateFor(entityx::Entity entity);
+  void markPending(entityx::Entity entity);
+  void wakeUp(entityx::Entity entity);
+  void putToSleep(entityx::Entity entity, const components::BoundingBox& bbox);
+  void stopTracking(entityx::Entity entity);
+  void removeFromAwakeList(EntityState& state);
+  void removeFromCells(EntityState& state);
+
+  template <typename Callback>
+  void forEachCell(const components::BoundingBox& bbox, Callback&& callback);
+
+  std::vector<EntityState> mStates;
+  std::vector<entityx::Entity> mAwakeEntities;
+  std::vector<entityx::Entity> mPendingEntities;
+  std::vector<entityx::Entity> mCandidatesScratch;
+  std::unordered_map<CellKey, std::vector<entityx::Entity>> mDormantCells;
+};
+
+} // namespace rigel::engine
@@ -57,6 +57,13 @@ constexpr auto WATER_ANIM_TEX_HEIGHT =
   nextPowerOf2(WATER_MASK_HEIGHT * WATER_NUM_MASKS);
 constexpr auto WATER_MASK_INDEX_FILLED = 4;
 
+// The water effect vertex shader tells quads for an animated surface apart
+// from filled ones by checking whether their mask tex coords are above 0.25.
+static_assert(WATER_MASK_HEIGHT / float(WATER_ANIM_TEX_HEIGHT) < 0.25f);
+static_assert(
+  WATER_MASK_INDEX_FILLED * WATER_MASK_HEIGHT / float(WATER_ANIM_TEX_HEIGHT) >
+  0.25f);
+
 
 // Applying the transform gives us a position in normalized device
 // coordinates (from -1.0 to 1.0). For sampling the render target texture,
@@ -67,6 +74,10 @@ constexpr auto WATER_MASK_INDEX_FILLED = 4;
 // We assume that the texture is as large as the screen, therefore sampling
 // with the resulting tex coords should be equivalent to reading the pixel
 // located at 'position'.
+//
+// Quads for an animated water surface always refer to the mask for the
+// first animation step, so that the geometry doesn't need to change during
+// animation. The current step is selected by offsetting the tex coords.
 const char* VERTEX_SOURCE_WATER_EFFECT = R"shd(
 ATTRIBUTE vec2 position;
 ATTRIBUTE vec2 texCoord;
@@ -75,13 +86,16 @@ OUT vec2 texCoordFrag;
 OUT vec2 texCoordMaskFrag;
 
 uniform mat4 transform;
+uniform float surfaceAnimationOffset;
 
 void main() {
   SET_POINT_SIZE(1.0);
   vec4 transformedPos = transform * vec4(position, 0.0, 1.0);
 
+  float maskOffset = texCoord.y < 0.25 ? surfaceAnimationOffset : 0.0;
+
   texCoordFrag = (transformedPos.xy + vec2(1.0, 1.0)) / 2.0;
-  texCoordMaskFrag = vec2(texCoord.x, 1.0 - texCoord.y);
+  texCoordMaskFrag = vec2(texCoord.x, 1.0 - (texCoord.y + maskOffset));
 
   gl_Position = transformedPos;
 }
@@ -143,6 +157,11 @@ const renderer::ShaderSpec WATER_EFFECT_SHADER{
   FRAGMENT_SOURCE_WATER_EFFECT};
 
 
+// Like the water effect, the cloak effect samples the background buffer at
+// the position where the sprite appears in the background buffer. See above
+// for how that works. When drawing directly on top of the background buffer,
+// backgroundTransform is the same as transform. When drawing into a
+// temporary buffer, it maps to the sprite's final position instead.
 const char* VERTEX_SOURCE_CLOAK_EFFECT = R"shd(
 ATTRIBUTE vec2 position;
 ATTRIBUTE vec2 texCoord;
@@ -373,6 +392,7 @@ SpecialEffectsRenderer::SpecialEffectsRenderer(
   , mWaterEffectShader(WATER_EFFECT_SHADER)
   , mCloakEffectShader(CLOAK_EFFECT_SHADER)
   , mBatch(&mWaterEffectShader)
+  , mCloakEffectBatch(&mCloakEffectShader)
   , mBackgroundBuffer(
       renderer::createFullscreenRenderTarget(mpRenderer, options))
   , mWaterSurfaceAnimTexture(pRenderer, createWaterSurfaceAnimImage())
@@ -405,21 +425,22 @@ void SpecialEffectsRenderer::drawBackgroundBuffer()
 }
 
 
-void SpecialEffectsRenderer::drawWaterEffect(
-  base::ArrayView<WaterEffectArea> areas,
-  int surfaceAnimationStep)
+void SpecialEffectsRenderer::setWaterEffectAreas(
+  base::ArrayView<WaterEffectArea> areas)
 {
-  if (areas.empty())
-  {
-    return;
-  }
-
-  assert(surfaceAnimationStep >= 0 && surfaceAnimationStep < 4);
-
-  mBatch.reset();
-  mBatch.preAllocateSpace(areas.size());
-
-  auto addArea = [&](
+  std::vector<WaterEffectArea> sortedAreas(areas.begin(), areas.end());
+  std::sort(
+    sortedAreas.begin(),
+    sortedAreas.end(),
+    [](const WaterEffectArea& lhs, const WaterEffectArea& rhs) {
+      return lhs.mArea.top() < rhs.mArea.top();
+    });
+
+  mWaterAreas.clear();
+  mWaterAreaQuads.clear();
+  mMaxWaterAreaHeight = 0;
+
+  auto addQuad = [&](
                    const base::Rect<int>& destRect,
                    const int maskIndex,
                    const int areaWidth) {
@@ -427,15 +448,16 @@ void SpecialEffectsRenderer::drawWaterEffect(
     const auto animSourceRect =
       base::Rect<int>{{0, maskTexStartY}, {areaWidth, WATER_MASK_HEIGHT}};
 
-    mBatch.addQuad(
+    mWaterAreaQuads.push_back(renderer::createTexturedQuadVertices(
       renderer::toTexCoords(
         animSourceRect, WATER_ANIM_TEX_WIDTH, WATER_ANIM_TEX_HEIGHT),
-      destRect);
+      destRect));
   };
 
-  for (const auto& areaSpec : areas)
+  for (const auto& areaSpec : sortedAreas)
   {
     const auto& area = areaSpec.mArea;
+    const auto firstQuad = int(mWaterAreaQuads.size());
 
     const auto areaWidth = area.size.width;
     if (areaSpec.mIsAnimated)
@@ -443,38 +465,137 @@ void SpecialEffectsRenderer::drawWaterEffect(
       const auto waterSurfaceArea =
         base::Rect<int>{area.topLeft, {areaWidth, WATER_MASK_HEIGHT}};
 
-      addArea(waterSurfaceArea, surfaceAnimationStep, areaWidth);
+      addQuad(waterSurfaceArea, 0, areaWidth);
 
       auto remainingArea = area;
       remainingArea.topLeft.y += WATER_MASK_HEIGHT;
       remainingArea.size.height -= WATER_MASK_HEIGHT;
 
-      addArea(remainingArea, WATER_MASK_INDEX_FILLED, areaWidth);
+      addQuad(remainingArea, WATER_MASK_INDEX_FILLED, areaWidth);
     }
     else
     {
-      addArea(area, WATER_MASK_INDEX_FILLED, areaWidth);
+      addQuad(area, WATER_MASK_INDEX_FILLED, areaWidth);
     }
+
+    mWaterAreas.push_back(PreparedWaterArea{
+      area, firstQuad, int(mWaterAreaQuads.size()) - firstQuad});
+    mMaxWaterAreaHeight = std::max(mMaxWaterAreaHeight, area.size.height);
   }
 
+  mBatch.reset();
+  mBatch.preAllocateSpace(int(mWaterAreaQuads.size()));
+}
+
+
+bool SpecialEffectsRenderer::selectVisibleWaterAreas(
+  const base::Rect<int>& visibleArea)
+{
+  mBatch.reset();
   mBatch.addTexture(mBackgroundBuffer.data());
   mBatch.addTexture(mWaterSurfaceAnimTexture.data());
   mBatch.addTexture(mRgbToPaletteIndexMap.data());
   mBatch.addTexture(mWaterEffectPaletteTexture.data());
 
+  // Areas starting above the visible area can still reach into it, but by
+  // no more than the height of the tallest area.
+  const auto firstCandidateTop = visibleArea.top() - mMaxWaterAreaHeight;
+  auto iArea = std::lower_bound(
+    mWaterAreas.begin(),
+    mWaterAreas.end(),
+    firstCandidateTop,
+    [](const PreparedWaterArea& area, const int top) {
+      return area.mArea.top() < top;
+    });
+
+  for (; iArea != mWaterAreas.end() &&
+       iArea->mArea.top() <= visibleArea.bottom();
+       ++iArea)
+  {
+    if (iArea->mArea.intersects(visibleArea))
+    {
+      for (auto i = 0; i < iArea->mNumQuads; ++i)
+      {
+        mBatch.addQuad(mWaterAreaQuads[iArea->mFirstQuad + i]);
+      }
+    }
+  }
+
+  return !mBatch.empty();
+}
+
+
+void SpecialEffectsRenderer::drawWaterEffect(const int surfaceAnimationStep)
+{
+  if (mBatch.empty())
+  {
+    return;
+  }
+
+  assert(surfaceAnimationStep >= 0 && surfaceAnimationStep < 4);
+
   mWaterEffectShader.use();
   mWaterEffectShader.setUniform(
     "transform", renderer::computeTransformationMatrix(mpRenderer));
+  mWaterEffectShader.setUniform(
+    "surfaceAnimationOffset",
+    surfaceAnimationStep * WATER_MASK_HEIGHT / float(WATER_ANIM_TEX_HEIGHT));
 
   mpRenderer->drawCustomQuadBatch(mBatch.data());
 }
 
 
 void SpecialEffectsRenderer::drawCloakEffect(
-  const renderer::TextureId textureId,
-  const renderer::TexCoords& texCoords,
-  const base::Rect<int>& destRect) const
+  base::ArrayView<CloakEffectSprite> sprites) const
+{
+  if (sprites.empty())
+  {
+    return;
+  }
+
+  const auto transform = renderer::computeTransformationMatrix(mpRenderer);
+  mCloakEffectShader.use();
+  mCloakEffectShader.setUniform("transform", transform);
+  mCloakEffectShader.setUniform("backgroundTransform", transform);
+
+  // All sprites using the same texture can be drawn in a single batch.
+  // Typically, there's only one batch, since cloaked sprites tend to be
+  // located on the same texture atlas page.
+  auto iBatchStart = sprites.begin();
+  while (iBatchStart != sprites.end())
+  {
+    const auto textureId = iBatchStart->mTextureId;
+    const auto iBatchEnd = std::find_if(
+      iBatchStart, sprites.end(), [&](const CloakEffectSprite& sprite) {
+        return sprite.mTextureId != textureId;
+      });
+
+    mCloakEffectBatch.reset();
+    mCloakEffectBatch.preAllocateSpace(
+      int(std::distance(iBatchStart, iBatchEnd)));
+
+    for (auto iSprite = iBatchStart; iSprite != iBatchEnd; ++iSprite)
+    {
+      mCloakEffectBatch.addQuad(iSprite->mTexCoords, iSprite->mDestRect);
+    }
+
+    mCloakEffectBatch.addTexture(mBackgroundBuffer.data());
+    mCloakEffectBatch.addTexture(textureId);
+    mCloakEffectBatch.addTexture(mRgbToPaletteIndexMap.data());
+    mCloakEffectBatch.addTexture(mCloakBlendMapTexture.data());
+
+    mpRenderer->drawCustomQuadBatch(mCloakEffectBatch.data());
+
+    iBatchStart = iBatchEnd;
+  }
+}
+
+
+void SpecialEffectsRenderer::drawCloakEffectIntoBackgroundBuffer(
+  const CloakEffectSprite& sprite) const
 {
+  const auto& destRect = sprite.mDestRect;
+
   if (
     mCloakEffectTempBuffer.width() < destRect.size.width ||
     mCloakEffectTempBuffer.height() < destRect.size.height)
@@ -495,11 +616,11 @@ void SpecialEffectsRenderer::drawCloakEffect(
 
     const auto textureIds = std::array{
       mBackgroundBuffer.data(),
-      textureId,
+      sprite.mTextureId,
       mRgbToPaletteIndexMap.data(),
       mCloakBlendMapTexture.data()};
-    const auto vertices =
-      renderer::createTexturedQuadVertices(texCoords, {{}, destRect.size});
+    const auto vertices = renderer::createTexturedQuadVertices(
+      sprite.mTexCoords, {{}, destRect.size});
 
     mCloakEffectShader.use();
     mCloakEffectShader.setUniform("backgroundTransform", backgroundTransform);
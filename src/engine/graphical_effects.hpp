@@ -20,6 +20,8 @@
 #include "renderer/shader.hpp"
 #include "renderer/texture.hpp"
 
+#include <vector>
+
 
 namespace rigel::data
 {
@@ -34,6 +36,7 @@ class Renderer;
 namespace rigel::engine
 {
 
+/** A water area in world space, in pixels */
 struct WaterEffectArea
 {
   base::Rect<int> mArea;
@@ -41,6 +44,14 @@ struct WaterEffectArea
 };
 
 
+struct CloakEffectSprite
+{
+  renderer::TextureId mTextureId;
+  renderer::TexCoords mTexCoords;
+  base::Rect<int> mDestRect;
+};
+
+
 class SpecialEffectsRenderer
 {
 public:
@@ -52,26 +63,71 @@ public:
   [[nodiscard]] auto bindBackgroundBuffer() { return mBackgroundBuffer.bind(); }
   void drawBackgroundBuffer();
 
-  void drawWaterEffect(
-    base::ArrayView<WaterEffectArea> areas,
-    int surfaceAnimationStep);
+  /** Prepare geometry for the water areas of the current level
+   *
+   * Water areas don't change during a level, so this only needs to be
+   * called once after loading.
+   */
+  void setWaterEffectAreas(base::ArrayView<WaterEffectArea> areas);
 
-  void drawCloakEffect(
-    renderer::TextureId textureId,
-    const renderer::TexCoords& texCoords,
-    const base::Rect<int>& destRect) const;
+  /** Select water areas overlapping the given world space rect for drawing
+   *
+   * Returns true if there are any such areas.
+   */
+  bool selectVisibleWaterAreas(const base::Rect<int>& visibleArea);
+
+  /** Draw the water areas chosen by selectVisibleWaterAreas()
+   *
+   * The renderer's translation must be set up to map world space
+   * coordinates to the screen.
+   */
+  void drawWaterEffect(int surfaceAnimationStep);
+
+  /** Draw sprites with the cloak effect applied
+   *
+   * The effect blends each sprite with the contents of the background
+   * buffer, which is sampled directly while drawing. The background buffer
+   * must therefore not be bound when calling this, and the current render
+   * target needs to be the same size as the background buffer.
+   */
+  void drawCloakEffect(base::ArrayView<CloakEffectSprite> sprites) const;
+
+  /** Draw a single sprite with the cloak effect into the background buffer
+   *
+   * Must be called while the background buffer is bound. The sprite is
+   * drawn into a temporary buffer first, which is then copied into the
+   * background buffer. That way, effects applied to the background buffer
+   * afterwards, like the water effect, affect the sprite as well. This
+   * needs two render target switches per sprite, so drawCloakEffect() is
+   * preferable when no such effects are visible.
+   */
+  void drawCloakEffectIntoBackgroundBuffer(
+    const CloakEffectSprite& sprite) const;
 
 private:
+  struct PreparedWaterArea
+  {
+    base::Rect<int> mArea;
+    int mFirstQuad;
+    int mNumQuads;
+  };
+
   renderer::Renderer* mpRenderer;
   renderer::Shader mWaterEffectShader;
   renderer::Shader mCloakEffectShader;
   renderer::CustomQuadBatch mBatch;
+  mutable renderer::CustomQuadBatch mCloakEffectBatch;
   renderer::RenderTargetTexture mBackgroundBuffer;
   mutable renderer::RenderTargetTexture mCloakEffectTempBuffer;
   renderer::Texture mWaterSurfaceAnimTexture;
   renderer::Texture mWaterEffectPaletteTexture;
   renderer::Texture mCloakBlendMapTexture;
   renderer::MonoTexture mRgbToPaletteIndexMap;
+
+  // Sorted by top edge
+  std::vector<PreparedWaterArea> mWaterAreas;
+  std::vector<renderer::QuadVertices> mWaterAreaQuads;
+  int mMaxWaterAreaHeight = 0;
 };
 
 } // namespace rigel::engine
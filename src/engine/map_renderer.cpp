@@ -190,6 +190,26 @@ constexpr auto TILE_SET_IMAGE_LOGICAL_SIZE = base::Size{
   tilesToPixels(data::GameTraits::CZone::tileSetImageWidth),
   tilesToPixels(data::GameTraits::CZone::tileSetImageHeight)};
 
+constexpr auto BACKDROP_IMAGE_LOGICAL_SIZE = base::Size{
+  data::GameTraits::viewportWidthPx,
+  data::GameTraits::viewportHeightPx};
+
+
+/** Upload image, with mipmaps if it's a high-res replacement */
+renderer::Texture createMapTexture(
+  renderer::Renderer* pRenderer,
+  const data::Image& image,
+  const base::Size& logicalSize)
+{
+  const auto imageSize = base::Size{
+    static_cast<int>(image.width()), static_cast<int>(image.height())};
+  const auto mipLevels =
+    renderer::mipLevelsForReplacement(imageSize, logicalSize);
+
+  return renderer::Texture(
+    pRenderer, image, data::createMipmaps(image, mipLevels));
+}
+
 } // namespace
 
 
@@ -239,25 +259,67 @@ TileRenderData::~TileRenderData()
 }
 
 
+MapTextureCache::MapTextureCache(renderer::Renderer* pRenderer)
+  : mpRenderer(pRenderer)
+{
+}
+
+
+std::shared_ptr<const TiledTexture>
+  MapTextureCache::tileSet(const std::string& name, const data::Image& image)
+{
+  auto& entry = mTileSets[name];
+  if (auto pTexture = entry.lock())
+  {
+    return pTexture;
+  }
+
+  auto pTexture = std::make_shared<const TiledTexture>(
+    createMapTexture(mpRenderer, image, TILE_SET_IMAGE_LOGICAL_SIZE),
+    TILE_SET_IMAGE_LOGICAL_SIZE,
+    mpRenderer);
+  entry = pTexture;
+  return pTexture;
+}
+
+
+std::shared_ptr<const renderer::Texture>
+  MapTextureCache::backdrop(const std::string& name, const data::Image& image)
+{
+  auto& entry = mBackdrops[name];
+  if (auto pTexture = entry.lock())
+  {
+    return pTexture;
+  }
+
+  auto pTexture = std::make_shared<const renderer::Texture>(
+    createMapTexture(mpRenderer, image, BACKDROP_IMAGE_LOGICAL_SIZE));
+  entry = pTexture;
+  return pTexture;
+}
+
+
 MapRenderer::MapRenderer(
   renderer::Renderer* pRenderer,
   const data::map::Map& map,
   const data::map::TileAttributeDict* pTileAttributes,
-  MapRenderData&& renderData)
+  MapRenderData&& renderData,
+  MapTextureCache* pTextureCache)
   : mpRenderer(pRenderer)
   , mpTileAttributes(pTileAttributes)
-  , mTileSetTexture(
-      renderer::Texture(pRenderer, renderData.mTileSetImage),
-      TILE_SET_IMAGE_LOGICAL_SIZE,
-      pRenderer)
-  , mBackdropTexture(mpRenderer, renderData.mBackdropImage)
-  , mRenderData(buildRenderData(map, mTileSetTexture, pRenderer))
+  , mpTileSetTexture(pTextureCache->tileSet(
+      renderData.mTileSetName,
+      renderData.mTileSetImage))
+  , mpBackdropTexture(pTextureCache->backdrop(
+      renderData.mBackdropName,
+      renderData.mBackdropImage))
+  , mRenderData(buildRenderData(map, *mpTileSetTexture, pRenderer))
   , mScrollMode(renderData.mBackdropScrollMode)
 {
   if (renderData.mSecondaryBackdropImage)
   {
-    mAlternativeBackdropTexture =
-      renderer::Texture(mpRenderer, *renderData.mSecondaryBackdropImage);
+    mpAlternativeBackdropTexture = pTextureCache->backdrop(
+      renderData.mSecondaryBackdropName, *renderData.mSecondaryBackdropImage);
   }
 }
 
@@ -271,17 +333,24 @@ void MapRenderer::synchronizeTo(const MapRenderer& other)
 
 bool MapRenderer::hasHighResReplacements() const
 {
-  return mBackdropTexture.width() > data::GameTraits::viewportWidthPx ||
-    mBackdropTexture.height() > data::GameTraits::viewportHeightPx ||
-    mAlternativeBackdropTexture.width() > data::GameTraits::viewportWidthPx ||
-    mAlternativeBackdropTexture.height() > data::GameTraits::viewportHeightPx ||
-    mTileSetTexture.isHighRes();
+  const auto isHighRes = [](const renderer::Texture& texture) {
+    return texture.width() > data::GameTraits::viewportWidthPx ||
+      texture.height() > data::GameTraits::viewportHeightPx;
+  };
+
+  return isHighRes(*mpBackdropTexture) ||
+    (mpAlternativeBackdropTexture &&
+     isHighRes(*mpAlternativeBackdropTexture)) ||
+    mpTileSetTexture->isHighRes();
 }
 
 
 void MapRenderer::switchBackdrops()
 {
-  std::swap(mBackdropTexture, mAlternativeBackdropTexture);
+  if (mpAlternativeBackdropTexture)
+  {
+    std::swap(mpBackdropTexture, mpAlternativeBackdropTexture);
+  }
 }
 
 
@@ -332,15 +401,15 @@ renderer::TexCoords MapRenderer::calculateBackdropTexCoords(
   // Let's start with determining the scale factors.
   const auto windowWidth = float(mpRenderer->currentRenderTargetSize().width);
   const auto windowHeight = float(mpRenderer->currentRenderTargetSize().height);
-  const auto scaleY = windowHeight / mBackdropTexture.height();
+  const auto scaleY = windowHeight / mpBackdropTexture->height();
 
   // Now that we know the scaling factor, we can determine the ratio between
   // the screen's width and the scaled background's width. Here we need to
   // take aspect ratio correction into account, in case we are working with
   // original art resolution and per-element upscaling.
   const auto isOriginalSize =
-    mBackdropTexture.width() == GameTraits::viewportWidthPx &&
-    mBackdropTexture.height() == GameTraits::viewportHeightPx;
+    mpBackdropTexture->width() == GameTraits::viewportWidthPx &&
+    mpBackdropTexture->height() == GameTraits::viewportHeightPx;
   const auto needsAspectRatioCorrection =
     isOriginalSize && windowHeight != GameTraits::viewportHeightPx;
   const auto correctionFactor = needsAspectRatioCorrection
@@ -353,7 +422,7 @@ renderer::TexCoords MapRenderer::calculateBackdropTexCoords(
   // need to apply in order to avoid horizontal stretching.
   // Basically, this is a measure of how much wider/narrower the background
   // image is in relation to the screen.
-  const auto scaledWidth = scaleX * mBackdropTexture.width();
+  const auto scaledWidth = scaleX * mpBackdropTexture->width();
   const auto remappingFactor = windowWidth / scaledWidth;
 
   // Then, we need to know what portion of the full screen is occupied by
@@ -386,8 +455,8 @@ renderer::TexCoords MapRenderer::calculateBackdropTexCoords(
     ? offset.y
     : offset.y * mpRenderer->globalScale().y / scaleY;
 
-  const auto left = offsetX / mBackdropTexture.width();
-  const auto top = offsetY / mBackdropTexture.height();
+  const auto left = offsetX / mpBackdropTexture->width();
+  const auto top = offsetY / mpBackdropTexture->height();
   const auto right = left + visibleTargetPortionX * remappingFactor;
   const auto bottom = top + visibleTargetPortionY;
 
@@ -402,7 +471,7 @@ void MapRenderer::renderBackdrop(
   const auto saved = renderer::saveState(mpRenderer);
   mpRenderer->setTextureRepeatEnabled(true);
   mpRenderer->drawTexture(
-    mBackdropTexture.data(),
+    mpBackdropTexture->data(),
     calculateBackdropTexCoords(cameraPosition, viewportSize),
     {{}, data::tilesToPixels(viewportSize)});
 }
@@ -454,13 +523,14 @@ void MapRenderer::renderMapTiles(
   const auto saved = renderer::saveState(mpRenderer);
   renderer::setLocalTranslation(mpRenderer, translation);
 
-  mpRenderer->submitVertexBuffers(blocksToRender, mTileSetTexture.textureId());
+  mpRenderer->submitVertexBuffers(
+    blocksToRender, mpTileSetTexture->textureId());
 
   forEachVisibleBlock([&](const TileBlock& block) {
     for (const auto& animated : block.mAnimatedTiles)
     {
       const auto tileIndexToDraw = animatedTileIndex(animated.mIndex);
-      mTileSetTexture.renderTile(
+      mpTileSetTexture->renderTile(
         tileIndexToDraw, animated.mPosition.x, animated.mPosition.y);
     }
   });
@@ -477,7 +547,7 @@ void MapRenderer::updateBackdropAutoScrolling(const engine::TimeDelta dt)
 {
   const auto scrollSpeed = std::invoke([&]() {
     const auto scale =
-      float(mBackdropTexture.height()) / GameTraits::viewportHeightPx;
+      float(mpBackdropTexture->height()) / GameTraits::viewportHeightPx;
 
     if (mScrollMode == BackdropScrollMode::AutoHorizontal)
     {
@@ -496,11 +566,11 @@ void MapRenderer::updateBackdropAutoScrolling(const engine::TimeDelta dt)
   const auto maxOffset = std::invoke([&]() {
     if (mScrollMode == BackdropScrollMode::AutoHorizontal)
     {
-      return float(mBackdropTexture.width());
+      return float(mpBackdropTexture->width());
     }
     else if (mScrollMode == BackdropScrollMode::AutoVertical)
     {
-      return float(mBackdropTexture.height());
+      return float(mpBackdropTexture->height());
     }
     else
     {
@@ -522,7 +592,7 @@ void MapRenderer::renderSingleTile(
   if (index != 0)
   {
     const auto tileIndexToDraw = animatedTileIndex(index);
-    mTileSetTexture.renderTileAtPixelPos(tileIndexToDraw, pixelPosition);
+    mpTileSetTexture->renderTileAtPixelPos(tileIndexToDraw, pixelPosition);
   }
 }
 
@@ -24,6 +24,9 @@
 #include "renderer/texture.hpp"
 
 #include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -75,6 +78,36 @@ std::vector<PackedTileData>
   copyMapData(const base::Rect<int>& section, const data::map::Map& map);
 
 
+/** Shares tile set and backdrop textures between MapRenderer instances
+ *
+ * Restarting a level, going back to a checkpoint or quick saving all create
+ * a new MapRenderer for the same level. Going through the cache lets these
+ * reuse the textures that are already on the GPU instead of uploading the
+ * same images again. Textures are identified by the name of the file they
+ * were loaded from (these images always use the game's default palette).
+ *
+ * The cache doesn't keep textures alive by itself, they are released once
+ * the last MapRenderer using them is destroyed.
+ */
+class MapTextureCache
+{
+public:
+  explicit MapTextureCache(renderer::Renderer* pRenderer);
+
+  std::shared_ptr<const TiledTexture>
+    tileSet(const std::string& name, const data::Image& image);
+  std::shared_ptr<const renderer::Texture>
+    backdrop(const std::string& name, const data::Image& image);
+
+private:
+  renderer::Renderer* mpRenderer;
+  std::unordered_map<std::string, std::weak_ptr<const TiledTexture>>
+    mTileSets;
+  std::unordered_map<std::string, std::weak_ptr<const renderer::Texture>>
+    mBackdrops;
+};
+
+
 class MapRenderer
 {
 public:
@@ -92,13 +125,17 @@ public:
     data::Image mBackdropImage;
     std::optional<data::Image> mSecondaryBackdropImage;
     data::map::BackdropScrollMode mBackdropScrollMode;
+    std::string mTileSetName;
+    std::string mBackdropName;
+    std::string mSecondaryBackdropName;
   };
 
   MapRenderer(
     renderer::Renderer* renderer,
     const data::map::Map& map,
     const data::map::TileAttributeDict* pTileAttributes,
-    MapRenderData&& renderData);
+    MapRenderData&& renderData,
+    MapTextureCache* pTextureCache);
 
   void synchronizeTo(const MapRenderer& other);
 
@@ -148,9 +185,9 @@ private:
   renderer::Renderer* mpRenderer;
   const data::map::TileAttributeDict* mpTileAttributes;
 
-  TiledTexture mTileSetTexture;
-  renderer::Texture mBackdropTexture;
-  renderer::Texture mAlternativeBackdropTexture;
+  std::shared_ptr<const TiledTexture> mpTileSetTexture;
+  std::shared_ptr<const renderer::Texture> mpBackdropTexture;
+  std::shared_ptr<const renderer::Texture> mpAlternativeBackdropTexture;
 
   TileRenderData mRenderData;
 
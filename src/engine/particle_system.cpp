@@ -24,8 +24,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <functional>
-#include <memory>
+#include <tuple>
 
 
 namespace rigel::engine
@@ -85,12 +84,12 @@ struct Particle
 using ParticlesList = std::array<Particle, 64>;
 
 
-std::unique_ptr<ParticlesList> createParticles(
+void initializeParticles(
+  ParticlesList& particles,
   RandomNumberGenerator& randomGenerator,
   const int velocityScaleX)
 {
-  auto pParticles = std::make_unique<ParticlesList>();
-  for (auto& particle : *pParticles)
+  for (auto& particle : particles)
   {
     const auto randomVariation = randomGenerator.gen() % 20;
     particle.mVelocityX = static_cast<std::int16_t>(
@@ -99,55 +98,25 @@ std::unique_ptr<ParticlesList> createParticles(
     particle.mInitialOffsetIndexY =
       randomGenerator.gen() % (INITIAL_INDEX_LIMIT + 1);
   }
-  return pParticles;
 }
 
-} // namespace
-
 
 struct ParticleGroup
 {
-  ParticleGroup(
-    const base::Vec2& origin,
-    const base::Color& color,
-    std::unique_ptr<ParticlesList> pParticles)
-    : mpParticles(std::move(pParticles))
-    , mOrigin(origin)
-    , mColor(color)
-  {
-  }
-
-  ParticleGroup(const ParticleGroup& other)
-    : mpParticles(std::make_unique<ParticlesList>(*other.mpParticles))
-    , mOrigin(other.mOrigin)
-    , mColor(other.mColor)
-  {
-  }
-
-  ParticleGroup& operator=(const ParticleGroup& other)
-  {
-    auto copy = other;
-    std::swap(mpParticles, copy.mpParticles);
-    mOrigin = copy.mOrigin;
-    mColor = copy.mColor;
-    mFramesElapsed = copy.mFramesElapsed;
-    return *this;
-  }
-
-  ParticleGroup(ParticleGroup&&) = default;
-  ParticleGroup& operator=(ParticleGroup&&) = default;
-
   void update() { ++mFramesElapsed; }
 
   void render(
     Renderer& renderer,
     const base::Vec2& cameraPosition,
-    const float interpolation)
+    const float interpolation) const
   {
     const auto screenSpaceOrigin =
       data::tilesToPixels(mOrigin - cameraPosition);
-    for (auto& particle : *mpParticles)
+
+    std::array<base::Vec2, std::tuple_size_v<ParticlesList>> positions;
+    for (auto i = 0u; i < mParticles.size(); ++i)
     {
+      const auto& particle = mParticles[i];
       const auto currentParticlePosition =
         particle.offsetAtTime(mFramesElapsed);
       const auto previousParticlePosition =
@@ -155,24 +124,121 @@ struct ParticleGroup
 
       const auto particlePosition = lerpRounded(
         previousParticlePosition, currentParticlePosition, interpolation);
-      renderer.drawPoint(screenSpaceOrigin + particlePosition, mColor);
+      positions[i] = screenSpaceOrigin + particlePosition;
     }
+
+    renderer.drawPoints(positions, mColor);
   }
 
 
   bool isExpired() const { return mFramesElapsed >= PARTICLE_SYSTEM_LIFE_TIME; }
 
-  std::unique_ptr<ParticlesList> mpParticles;
+  ParticlesList mParticles;
   base::Vec2 mOrigin;
   base::Color mColor;
   int mFramesElapsed = 0;
 };
 
 
+// Each group lives for PARTICLE_SYSTEM_LIFE_TIME frames, so this allows for
+// spawning more than 4 groups on every single frame.
+constexpr auto MAX_PARTICLE_GROUPS = 128;
+
+} // namespace
+
+
+struct ParticleSystem::Pool
+{
+  using SlotIndex = std::uint8_t;
+
+  static_assert(MAX_PARTICLE_GROUPS <= 256);
+
+  Pool()
+  {
+    for (auto i = 0; i < MAX_PARTICLE_GROUPS; ++i)
+    {
+      mFreeSlots[i] = static_cast<SlotIndex>(MAX_PARTICLE_GROUPS - 1 - i);
+    }
+    mNumFreeSlots = MAX_PARTICLE_GROUPS;
+  }
+
+  void copyLiveGroupsFrom(const Pool& other)
+  {
+    for (auto i = 0; i < other.mNumLiveGroups; ++i)
+    {
+      const auto slot = other.mLiveSlots[i];
+      mGroups[slot] = other.mGroups[slot];
+    }
+
+    mLiveSlots = other.mLiveSlots;
+    mFreeSlots = other.mFreeSlots;
+    mNumLiveGroups = other.mNumLiveGroups;
+    mNumFreeSlots = other.mNumFreeSlots;
+  }
+
+  ParticleGroup& allocate()
+  {
+    if (mNumFreeSlots == 0)
+    {
+      // Reuse the oldest group. Live slots are kept in spawn order, so
+      // that's the first one.
+      const auto oldestSlot = mLiveSlots[0];
+      std::copy(
+        mLiveSlots.begin() + 1,
+        mLiveSlots.begin() + mNumLiveGroups,
+        mLiveSlots.begin());
+      mLiveSlots[mNumLiveGroups - 1] = oldestSlot;
+      return mGroups[oldestSlot];
+    }
+
+    const auto slot = mFreeSlots[--mNumFreeSlots];
+    mLiveSlots[mNumLiveGroups++] = slot;
+    return mGroups[slot];
+  }
+
+  void releaseExpired()
+  {
+    auto numRemaining = 0;
+    for (auto i = 0; i < mNumLiveGroups; ++i)
+    {
+      const auto slot = mLiveSlots[i];
+      if (mGroups[slot].isExpired())
+      {
+        mFreeSlots[mNumFreeSlots++] = slot;
+      }
+      else
+      {
+        mLiveSlots[numRemaining++] = slot;
+      }
+    }
+
+    mNumLiveGroups = numRemaining;
+  }
+
+  template <typename Func>
+  void forEachLiveGroup(Func&& func)
+  {
+    for (auto i = 0; i < mNumLiveGroups; ++i)
+    {
+      func(mGroups[mLiveSlots[i]]);
+    }
+  }
+
+  std::array<ParticleGroup, MAX_PARTICLE_GROUPS> mGroups;
+
+  // Slot indices of live groups in spawn order, followed by unused entries
+  std::array<SlotIndex, MAX_PARTICLE_GROUPS> mLiveSlots{};
+  std::array<SlotIndex, MAX_PARTICLE_GROUPS> mFreeSlots{};
+  int mNumLiveGroups = 0;
+  int mNumFreeSlots = 0;
+};
+
+
 ParticleSystem::ParticleSystem(
   RandomNumberGenerator* pRandomGenerator,
   Renderer* pRenderer)
-  : mpRandomGenerator(pRandomGenerator)
+  : mpPool(std::make_unique<Pool>())
+  , mpRandomGenerator(pRandomGenerator)
   , mpRenderer(pRenderer)
 {
 }
@@ -183,7 +249,7 @@ ParticleSystem::~ParticleSystem() = default;
 
 void ParticleSystem::synchronizeTo(const ParticleSystem& other)
 {
-  mParticleGroups = other.mParticleGroups;
+  mpPool->copyLiveGroupsFrom(*other.mpPool);
 }
 
 
@@ -192,26 +258,18 @@ void ParticleSystem::spawnParticles(
   const base::Color& color,
   int velocityScaleX)
 {
-  auto pParticles = createParticles(*mpRandomGenerator, velocityScaleX);
-  mParticleGroups.emplace_back(
-    origin + SPAWN_OFFSET, color, std::move(pParticles));
+  auto& group = mpPool->allocate();
+  initializeParticles(group.mParticles, *mpRandomGenerator, velocityScaleX);
+  group.mOrigin = origin + SPAWN_OFFSET;
+  group.mColor = color;
+  group.mFramesElapsed = 0;
 }
 
 
 void ParticleSystem::update()
 {
-  using namespace std;
-
-  const auto it = remove_if(
-    begin(mParticleGroups),
-    end(mParticleGroups),
-    mem_fn(&ParticleGroup::isExpired));
-  mParticleGroups.erase(it, end(mParticleGroups));
-
-  for (auto& group : mParticleGroups)
-  {
-    group.update();
-  }
+  mpPool->releaseExpired();
+  mpPool->forEachLiveGroup([](ParticleGroup& group) { group.update(); });
 }
 
 
@@ -219,10 +277,9 @@ void ParticleSystem::render(
   const base::Vec2& cameraPosition,
   const float interpolation)
 {
-  for (auto& group : mParticleGroups)
-  {
+  mpPool->forEachLiveGroup([&](const ParticleGroup& group) {
     group.render(*mpRenderer, cameraPosition, interpolation);
-  }
+  });
 }
 
 } // namespace rigel::engine
@@ -19,7 +19,7 @@
 #include "base/color.hpp"
 #include "base/spatial_types.hpp"
 
-#include <vector>
+#include <memory>
 
 namespace rigel::renderer
 {
@@ -32,9 +32,14 @@ namespace rigel::engine
 
 class RandomNumberGenerator;
 
-struct ParticleGroup;
-
 
+/** Simple particle effects, as used for explosions and debris
+ *
+ * Particle groups are kept in a fixed-size pool which is allocated once
+ * on construction, so spawning particles and synchronizing to another
+ * particle system (e.g. for quick saves) doesn't allocate memory. If all
+ * slots are in use, spawning replaces the oldest group.
+ */
 class ParticleSystem
 {
 public:
@@ -54,7 +59,9 @@ public:
   void render(const base::Vec2& cameraPosition, float interpolation);
 
 private:
-  std::vector<ParticleGroup> mParticleGroups;
+  struct Pool;
+
+  std::unique_ptr<Pool> mpPool;
   RandomNumberGenerator* mpRandomGenerator;
   renderer::Renderer* mpRenderer;
 };
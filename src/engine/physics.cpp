@@ -93,6 +93,19 @@ std::optional<PhysicsCollisionInfo> applyPhysics(
   const auto originalPosition = position;
 
   const auto movementX = static_cast<std::int16_t>(body.mVelocity.x);
+
+  if (body.mIgnoreCollisions && !body.mGravityAffected)
+  {
+    // Fast path: The body would end up at the target position anyway (see
+    // the mIgnoreCollisions handling below), and without gravity, the
+    // vertical velocity doesn't depend on the world either. So we can skip
+    // all the collision checks. Since the final position always equals the
+    // target position, there is also never a collision to report.
+    const auto movementY = static_cast<std::int16_t>(body.mVelocity.y);
+    position = originalPosition + WorldPosition{movementX, movementY};
+    return {};
+  }
+
   moveHorizontally(collisionChecker, entity, movementX);
 
   // Cache new world space BBox after applying horizontal movement
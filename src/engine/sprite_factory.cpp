@@ -19,8 +19,11 @@
 #include "assets/resource_loader.hpp"
 #include "base/container_utils.hpp"
 #include "data/unit_conversions.hpp"
+#include "renderer/texture.hpp"
 
+#include <algorithm>
 #include <array>
+#include <optional>
 
 
 namespace rigel::engine
@@ -287,6 +290,49 @@ constexpr auto INGAME_SPRITE_ACTOR_IDS = std::array{
 };
 
 
+// Actors which can appear during gameplay regardless of what the level
+// contains, because they are spawned by the player, by weapons, or as
+// generic effects when shooting or destroying things. These are always
+// prefetched along with a level's actors.
+constexpr auto RUNTIME_SPAWNED_ACTOR_IDS = std::array{
+  data::ActorID::Duke_LEFT,
+  data::ActorID::Duke_RIGHT,
+  data::ActorID::Duke_regular_shot_horizontal,
+  data::ActorID::Duke_regular_shot_vertical,
+  data::ActorID::Duke_laser_shot_horizontal,
+  data::ActorID::Duke_laser_shot_vertical,
+  data::ActorID::Duke_rocket_up,
+  data::ActorID::Duke_rocket_down,
+  data::ActorID::Duke_rocket_left,
+  data::ActorID::Duke_rocket_right,
+  data::ActorID::Duke_flame_shot_up,
+  data::ActorID::Duke_flame_shot_down,
+  data::ActorID::Duke_flame_shot_left,
+  data::ActorID::Duke_flame_shot_right,
+  data::ActorID::Muzzle_flash_up,
+  data::ActorID::Muzzle_flash_down,
+  data::ActorID::Muzzle_flash_left,
+  data::ActorID::Muzzle_flash_right,
+  data::ActorID::Duke_death_particles,
+  data::ActorID::Explosion_FX_1,
+  data::ActorID::Explosion_FX_2,
+  data::ActorID::Shot_impact_FX,
+  data::ActorID::Smoke_puff_FX,
+  data::ActorID::Smoke_cloud_FX,
+  data::ActorID::White_circle_flash_FX,
+  data::ActorID::Nuclear_explosion,
+  data::ActorID::Biological_enemy_debris,
+  data::ActorID::Yellow_fireball_FX,
+  data::ActorID::Green_fireball_FX,
+  data::ActorID::Blue_fireball_FX,
+  data::ActorID::Score_number_FX_100,
+  data::ActorID::Score_number_FX_500,
+  data::ActorID::Score_number_FX_2000,
+  data::ActorID::Score_number_FX_5000,
+  data::ActorID::Score_number_FX_10000,
+};
+
+
 void applyTweaks(
   std::vector<engine::SpriteFrame>& frames,
   const ActorID actorId)
@@ -799,6 +845,15 @@ int adjustedDrawOrder(const ActorID id, const int baseDrawOrder)
   }
 }
 
+
+bool isIngameSpriteActor(const ActorID id)
+{
+  return std::find(
+           INGAME_SPRITE_ACTOR_IDS.begin(),
+           INGAME_SPRITE_ACTOR_IDS.end(),
+           id) != INGAME_SPRITE_ACTOR_IDS.end();
+}
+
 } // namespace
 
 
@@ -837,33 +892,56 @@ bool hasAssociatedSprite(const ActorID actorID)
 
 SpriteFactory::SpriteFactory(
   renderer::Renderer* pRenderer,
-  const assets::ResourceLoader* pResourceLoader)
-  : SpriteFactory(construct(pRenderer, pResourceLoader))
+  const assets::ResourceLoader* pResourceLoader,
+  const LoadingMode loadingMode)
+  : mSpritesTextureAtlas(pRenderer)
+  , mHasHighResReplacements(pResourceLoader->hasHighResSpriteReplacements())
+  , mpResourceLoader(pResourceLoader)
 {
+  if (loadingMode == LoadingMode::Eager)
+  {
+    loadSprites(INGAME_SPRITE_ACTOR_IDS);
+  }
 }
 
 
-SpriteFactory::SpriteFactory(CtorArgs args)
-  : mSpriteDataMap(std::move(std::get<0>(args)))
-  , mSpritesTextureAtlas(std::move(std::get<1>(args)))
-  , mHasHighResReplacements(std::get<2>(args))
+void SpriteFactory::prefetch(base::ArrayView<data::ActorID> ids)
 {
+  auto allIds = std::vector<ActorID>{ids.begin(), ids.end()};
+  allIds.insert(
+    allIds.end(),
+    RUNTIME_SPAWNED_ACTOR_IDS.begin(),
+    RUNTIME_SPAWNED_ACTOR_IDS.end());
+  loadSprites(allIds);
 }
 
 
-auto SpriteFactory::construct(
-  renderer::Renderer* pRenderer,
-  const assets::ResourceLoader* pResourceLoader) -> CtorArgs
+auto SpriteFactory::spriteData(const ActorID id) const -> const SpriteData&
 {
-  bool highResReplacementsFound = false;
+  if (!mSpriteDataMap.count(id))
+  {
+    loadSprites(base::ArrayView<ActorID>{&id, 1});
+  }
+
+  return mSpriteDataMap.at(id);
+}
 
-  std::unordered_map<data::ActorID, SpriteData> spriteDataMap;
 
+void SpriteFactory::loadSprites(base::ArrayView<ActorID> ids) const
+{
   std::vector<data::Image> spriteImages;
-  spriteImages.reserve(INGAME_SPRITE_ACTOR_IDS.size());
+  const auto firstImageIndex = mSpritesTextureAtlas.size();
+
+  // Number of mip levels needed for this batch's high-res replacements
+  std::optional<int> mipLevels;
 
-  for (const auto mainId : INGAME_SPRITE_ACTOR_IDS)
+  for (const auto mainId : ids)
   {
+    if (!isIngameSpriteActor(mainId) || mSpriteDataMap.count(mainId))
+    {
+      continue;
+    }
+
     engine::SpriteDrawData drawData;
 
     int lastDrawOrder = 0;
@@ -875,7 +953,7 @@ auto SpriteFactory::construct(
     // non-const so we can move the Image objects into the vector
     auto actorParts =
       utils::transformed(actorPartIds, [&](const ActorID partId) {
-        return pResourceLoader->loadActor(partId);
+        return mpResourceLoader->loadActor(partId);
       });
 
     // Similarly, non-const for move semantics
@@ -888,7 +966,7 @@ auto SpriteFactory::construct(
       {
         auto& image = frameData.mFrameImage;
         drawData.mFrames.emplace_back(engine::SpriteFrame{
-          int(spriteImages.size()),
+          firstImageIndex + int(spriteImages.size()),
           frameData.mDrawOffset,
           frameData.mLogicalSize});
 
@@ -898,7 +976,11 @@ auto SpriteFactory::construct(
           data::tilesToPixels(frameData.mLogicalSize.height) <
             int(image.height()))
         {
-          highResReplacementsFound = true;
+          const auto frameMipLevels = renderer::mipLevelsForReplacement(
+            {int(image.width()), int(image.height())},
+            data::tilesToPixels(frameData.mLogicalSize));
+          mipLevels =
+            std::min(mipLevels.value_or(frameMipLevels), frameMipLevels);
         }
 
         spriteImages.emplace_back(std::move(image));
@@ -914,20 +996,25 @@ auto SpriteFactory::construct(
 
     applyTweaks(drawData.mFrames, mainId);
 
-    spriteDataMap.emplace(
+    mSpriteDataMap.emplace(
       mainId, SpriteData{std::move(drawData), std::move(framesToRender)});
   }
 
-  return {
-    std::move(spriteDataMap),
-    renderer::TextureAtlas{pRenderer, spriteImages},
-    highResReplacementsFound};
+  if (mipLevels)
+  {
+    mSpritesTextureAtlas.setMipLevels(*mipLevels);
+  }
+
+  if (!spriteImages.empty())
+  {
+    mSpritesTextureAtlas.addImages(spriteImages);
+  }
 }
 
 
 Sprite SpriteFactory::createSprite(const ActorID id)
 {
-  const auto& data = mSpriteDataMap.at(id);
+  const auto& data = spriteData(id);
   auto sprite = Sprite{&data.mDrawData, data.mInitialFramesToRender};
   configureSprite(sprite, id);
   return sprite;
@@ -945,7 +1032,7 @@ base::Rect<int>
 engine::SpriteFrame
   SpriteFactory::actorFrameData(data::ActorID id, int frame) const
 {
-  const auto& data = mSpriteDataMap.at(id);
+  const auto& data = spriteData(id);
   const auto realFrame =
     virtualToRealFrame(frame, data.mDrawData, std::nullopt);
   return data.mDrawData.mFrames[realFrame];
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "base/array_view.hpp"
 #include "data/game_traits.hpp"
 #include "engine/isprite_factory.hpp"
 #include "renderer/texture_atlas.hpp"
@@ -52,14 +53,39 @@ bool hasAssociatedSprite(data::ActorID actorID);
 class SpriteFactory : public ISpriteFactory
 {
 public:
+  enum class LoadingMode
+  {
+    /** Load all in-game sprites on construction */
+    Eager,
+
+    /** Load each actor's sprite the first time it's needed */
+    OnDemand
+  };
+
   SpriteFactory(
     renderer::Renderer* pRenderer,
-    const assets::ResourceLoader* pResourceLoader);
+    const assets::ResourceLoader* pResourceLoader,
+    LoadingMode loadingMode = LoadingMode::OnDemand);
 
   engine::components::Sprite createSprite(data::ActorID id) override;
   base::Rect<int> actorFrameRect(data::ActorID id, int frame) const override;
   SpriteFrame actorFrameData(data::ActorID id, int frame) const override;
 
+  /** Load sprites for all actors in the given list
+   *
+   * Sprites which are already loaded are skipped. Loading all sprites
+   * needed for a level in one go is more efficient than loading them
+   * one by one as entities are created, and avoids loading hiccups during
+   * gameplay. Actors which can appear in any level, like the player's
+   * shots and generic effects, are loaded as well.
+   */
+  void prefetch(base::ArrayView<data::ActorID> ids);
+
+  /** True if any sprite is replaced by a high-res image
+   *
+   * This is determined up front from the available replacement files, so
+   * it doesn't depend on which sprites have been loaded so far.
+   */
   bool hasHighResReplacements() const { return mHasHighResReplacements; }
 
   const renderer::TextureAtlas& textureAtlas() const
@@ -74,19 +100,15 @@ private:
     std::vector<int> mInitialFramesToRender;
   };
 
-  using CtorArgs = std::tuple<
-    std::unordered_map<data::ActorID, SpriteData>,
-    renderer::TextureAtlas,
-    bool>;
-
-  SpriteFactory(CtorArgs args);
-  static CtorArgs construct(
-    renderer::Renderer* pRenderer,
-    const assets::ResourceLoader* pResourceLoader);
+  const SpriteData& spriteData(data::ActorID id) const;
+  void loadSprites(base::ArrayView<data::ActorID> ids) const;
 
-  std::unordered_map<data::ActorID, SpriteData> mSpriteDataMap;
-  renderer::TextureAtlas mSpritesTextureAtlas;
-  bool mHasHighResReplacements;
+  // Sprites are loaded lazily from within const member functions, hence
+  // the mutable
+  mutable std::unordered_map<data::ActorID, SpriteData> mSpriteDataMap;
+  mutable renderer::TextureAtlas mSpritesTextureAtlas;
+  const bool mHasHighResReplacements;
+  const assets::ResourceLoader* mpResourceLoader;
 };
 
 } // namespace rigel::engine
@@ -17,7 +17,6 @@
 #include "sprite_rendering_system.hpp"
 
 #include "data/unit_conversions.hpp"
-#include "engine/graphical_effects.hpp"
 #include "engine/motion_smoothing.hpp"
 #include "engine/sprite_tools.hpp"
 #include "engine/visual_components.hpp"
@@ -45,6 +44,13 @@ using components::WorldPosition;
 namespace
 {
 
+bool usesCloakEffect(const SpriteDrawSpec& spec)
+{
+  // White flash takes priority over translucency
+  return spec.mUseCloakEffect && !spec.mIsFlashingWhite;
+}
+
+
 void advanceAnimation(Sprite& sprite, AnimationLoop& animated)
 {
   const auto numFrames = static_cast<int>(sprite.mpDrawData->mFrames.size());
@@ -72,8 +78,7 @@ void collectVisibleSprites(
   ex::EntityManager& es,
   const base::Vec2& cameraPosition,
   const base::Size& viewportSize,
-  std::vector<SortableDrawSpec>& output,
-  const float interpolationFactor)
+  std::vector<SortableDrawSpec>& output)
 {
   using components::BoundingBox;
   using components::DrawTopMost;
@@ -111,14 +116,18 @@ void collectVisibleSprites(
 
     const auto previousTopLeft = drawPosition(frame, previousPosition);
 
-    const auto destRect = base::Rect<int>{
-      engine::interpolatedPixelPosition(
-        previousTopLeft, topLeft, interpolationFactor),
-      data::tilesToPixels(frame.mDimensions)};
+    // The position is filled in by interpolateSprites()
+    const auto destRect =
+      base::Rect<int>{{}, data::tilesToPixels(frame.mDimensions)};
     const auto drawSpec =
       SpriteDrawSpec{destRect, frame.mImageId, flashingWhite, useCloakEffect};
+    const auto motion = SpriteMotion{
+      data::tilesToPixels(previousTopLeft),
+      data::tilesToPixels(topLeft),
+      destRect.size.height,
+      destRect.size.height};
 
-    output.push_back({drawSpec, drawOrder, drawTopmost});
+    output.push_back({drawSpec, motion, drawOrder, drawTopmost});
   };
 
 
@@ -201,18 +210,17 @@ void collectVisibleSprites(
         }
 
         const auto width = data::tilesToPixels(frame.mDimensions.width);
-        const auto height = base::round(data::tilesToPixels(base::lerp(
-          float(strip.mPreviousHeight),
-          float(strip.mHeight),
-          interpolationFactor)));
-
-        const auto destRect =
-          base::Rect<int>{data::tilesToPixels(topLeft), {width, height}};
+        const auto destRect = base::Rect<int>{{}, {width, 0}};
 
         const auto useCloakEffect = sprite.mUseCloakEffect;
         const auto drawSpec =
           SpriteDrawSpec{destRect, frame.mImageId, false, useCloakEffect};
-        output.push_back({drawSpec, drawOrder, drawTopmost});
+        const auto motion = SpriteMotion{
+          data::tilesToPixels(topLeft),
+          data::tilesToPixels(topLeft),
+          data::tilesToPixels(strip.mPreviousHeight),
+          data::tilesToPixels(strip.mHeight)};
+        output.push_back({drawSpec, motion, drawOrder, drawTopmost});
       }
     });
 }
@@ -319,16 +327,25 @@ SpriteRenderingSystem::SpriteRenderingSystem(
 void SpriteRenderingSystem::update(
   ex::EntityManager& es,
   const base::Size& viewportSize,
-  const base::Vec2& cameraPosition,
-  const float interpolationFactor)
+  const base::Vec2& cameraPosition)
 {
   using std::back_inserter;
   using std::begin;
   using std::end;
 
+  if (
+    !mSpritesOutdated && viewportSize == mViewportSize &&
+    cameraPosition == mCameraPosition)
+  {
+    return;
+  }
+
+  mSpritesOutdated = false;
+  mViewportSize = viewportSize;
+  mCameraPosition = cameraPosition;
+
   mSortBuffer.clear();
-  collectVisibleSprites(
-    es, cameraPosition, viewportSize, mSortBuffer, interpolationFactor);
+  collectVisibleSprites(es, cameraPosition, viewportSize, mSortBuffer);
   std::stable_sort(begin(mSortBuffer), end(mSortBuffer));
 
   mSprites.clear();
@@ -339,6 +356,14 @@ void SpriteRenderingSystem::update(
     back_inserter(mSprites),
     [](const SortableDrawSpec& sortableSpec) { return sortableSpec.mSpec; });
 
+  mSpriteMotions.clear();
+  mSpriteMotions.reserve(mSortBuffer.size());
+  std::transform(
+    begin(mSortBuffer),
+    end(mSortBuffer),
+    back_inserter(mSpriteMotions),
+    [](const SortableDrawSpec& sortableSpec) { return sortableSpec.mMotion; });
+
   const auto iFirstTopMostSprite = std::find_if(
     begin(mSortBuffer),
     end(mSortBuffer),
@@ -348,53 +373,138 @@ void SpriteRenderingSystem::update(
     begin(mSprites), std::distance(begin(mSortBuffer), iFirstTopMostSprite));
 
   mCloakEffectSpritesVisible =
-    std::any_of(begin(mSprites), end(mSprites), [](const SpriteDrawSpec& spec) {
-      return spec.mUseCloakEffect;
-    });
+    std::any_of(begin(mSprites), end(mSprites), usesCloakEffect);
+}
+
+
+void SpriteRenderingSystem::interpolate(const float interpolationFactor)
+{
+  assert(mSprites.size() == mSpriteMotions.size());
+
+  for (auto i = 0u; i < mSprites.size(); ++i)
+  {
+    const auto& motion = mSpriteMotions[i];
+    auto& destRect = mSprites[i].mDestRect;
+
+    destRect.topLeft = lerpRounded(
+      motion.mPreviousTopLeft, motion.mTopLeft, interpolationFactor);
+    destRect.size.height = base::round(base::lerp(
+      float(motion.mPreviousHeight),
+      float(motion.mHeight),
+      interpolationFactor));
+  }
 }
 
 
 void SpriteRenderingSystem::renderRegularSprites(
+  const SpecialEffectsRenderer& fx,
+  const bool drawCloakedSprites) const
+{
+  for (auto it = mSprites.cbegin(); it != miForegroundSprites; ++it)
+  {
+    if (!usesCloakEffect(*it))
+    {
+      renderSprite(*it);
+    }
+    else if (drawCloakedSprites)
+    {
+      const auto [textureId, texCoords] =
+        mpTextureAtlas->drawData(it->mImageId);
+      fx.drawCloakEffectIntoBackgroundBuffer(
+        {textureId, texCoords, it->mDestRect});
+    }
+  }
+}
+
+
+void SpriteRenderingSystem::renderCloakedRegularSprites(
   const SpecialEffectsRenderer& fx) const
 {
-  for (auto it = mSprites.begin(); it != miForegroundSprites; ++it)
+  const auto iFirstCloaked =
+    firstCloakedSprite(mSprites.cbegin(), miForegroundSprites);
+  if (iFirstCloaked == miForegroundSprites)
   {
-    renderSprite(*it, fx);
+    return;
   }
+
+  renderCloakedSprites(iFirstCloaked, miForegroundSprites, fx);
+
+  // These are already in the background buffer, but need to appear on top
+  // of the cloaked sprites
+  renderNonCloakedSprites(std::next(iFirstCloaked), miForegroundSprites);
 }
 
 
 void SpriteRenderingSystem::renderForegroundSprites(
   const SpecialEffectsRenderer& fx) const
 {
-  for (auto it = miForegroundSprites; it != mSprites.end(); ++it)
+  const auto iFirstCloaked =
+    firstCloakedSprite(miForegroundSprites, mSprites.cend());
+  renderNonCloakedSprites(miForegroundSprites, iFirstCloaked);
+
+  if (iFirstCloaked != mSprites.cend())
   {
-    renderSprite(*it, fx);
+    renderCloakedSprites(iFirstCloaked, mSprites.cend(), fx);
+    renderNonCloakedSprites(std::next(iFirstCloaked), mSprites.cend());
   }
 }
 
 
-void SpriteRenderingSystem::renderSprite(
-  const SpriteDrawSpec& spec,
-  const SpecialEffectsRenderer& fx) const
+void SpriteRenderingSystem::renderSprite(const SpriteDrawSpec& spec) const
 {
-  // White flash takes priority over translucency
   if (spec.mIsFlashingWhite)
   {
     const auto saved = renderer::saveState(mpRenderer);
     mpRenderer->setOverlayColor(data::GameTraits::INGAME_PALETTE[15]);
     mpTextureAtlas->draw(spec.mImageId, spec.mDestRect);
   }
-  else if (spec.mUseCloakEffect)
+  else
   {
-    const auto [textureId, texCoords] = mpTextureAtlas->drawData(spec.mImageId);
+    mpTextureAtlas->draw(spec.mImageId, spec.mDestRect);
+  }
+}
+
+
+auto SpriteRenderingSystem::firstCloakedSprite(
+  const SpriteIter first,
+  const SpriteIter last) const -> SpriteIter
+{
+  return std::find_if(first, last, usesCloakEffect);
+}
+
 
-    fx.drawCloakEffect(textureId, texCoords, spec.mDestRect);
+void SpriteRenderingSystem::renderNonCloakedSprites(
+  const SpriteIter first,
+  const SpriteIter last) const
+{
+  for (auto it = first; it != last; ++it)
+  {
+    if (!usesCloakEffect(*it))
+    {
+      renderSprite(*it);
+    }
   }
-  else
+}
+
+
+void SpriteRenderingSystem::renderCloakedSprites(
+  const SpriteIter first,
+  const SpriteIter last,
+  const SpecialEffectsRenderer& fx) const
+{
+  mCloakEffectSprites.clear();
+
+  for (auto it = first; it != last; ++it)
   {
-    mpTextureAtlas->draw(spec.mImageId, spec.mDestRect);
+    if (usesCloakEffect(*it))
+    {
+      const auto [textureId, texCoords] =
+        mpTextureAtlas->drawData(it->mImageId);
+      mCloakEffectSprites.push_back({textureId, texCoords, it->mDestRect});
+    }
   }
+
+  fx.drawCloakEffect(mCloakEffectSprites);
 }
 
 } // namespace rigel::engine
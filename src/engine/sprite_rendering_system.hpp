@@ -19,6 +19,7 @@
 #include "base/spatial_types.hpp"
 #include "base/warnings.hpp"
 #include "engine/base_components.hpp"
+#include "engine/graphical_effects.hpp"
 #include "renderer/renderer.hpp"
 #include "renderer/texture.hpp"
 
@@ -39,8 +40,6 @@ class TextureAtlas;
 namespace rigel::engine
 {
 
-class SpecialEffectsRenderer;
-
 
 /** Animates sprites with an AnimationLoop component
  *
@@ -60,9 +59,24 @@ struct SpriteDrawSpec
 };
 
 
+/** Positions in pixels at the previous and current game logic update
+ *
+ * Used for interpolating a sprite's on-screen position when motion smoothing
+ * is enabled. The height can change for sprite strips.
+ */
+struct SpriteMotion
+{
+  base::Vec2 mPreviousTopLeft;
+  base::Vec2 mTopLeft;
+  int mPreviousHeight;
+  int mHeight;
+};
+
+
 struct SortableDrawSpec
 {
   SpriteDrawSpec mSpec;
+  SpriteMotion mMotion;
   int mDrawOrder;
   bool mDrawTopMost;
 
@@ -82,20 +96,67 @@ public:
     renderer::Renderer* pRenderer,
     const renderer::TextureAtlas* pTextureAtlas);
 
+  /** Collect, cull and sort all sprites visible in the given viewport
+   *
+   * This is only necessary once per game logic update. If the viewport is
+   * the same as on the previous call, and invalidate() hasn't been called
+   * since, this does nothing. Sprite positions must then be computed
+   * by calling interpolate(), which is cheap enough to do every frame.
+   */
   void update(
     entityx::EntityManager& es,
     const base::Size& viewportSize,
-    const base::Vec2& cameraPosition,
-    float interpolationFactor);
+    const base::Vec2& cameraPosition);
+
+  /** Mark collected sprites as outdated, e.g. after a game logic update */
+  void invalidate() { mSpritesOutdated = true; }
+
+  /** Compute sprite positions for the given interpolation factor
+   *
+   * A factor of 0 gives the positions as of the previous game logic update,
+   * 1 gives the current positions.
+   */
+  void interpolate(float interpolationFactor);
 
   bool cloakEffectSpritesVisible() const { return mCloakEffectSpritesVisible; }
 
-  void renderRegularSprites(const SpecialEffectsRenderer& fx) const;
+  /** Draw all regular sprites into the background buffer
+   *
+   * If drawCloakedSprites is true, sprites using the cloak effect are drawn
+   * one by one at their place in the draw order, see
+   * SpecialEffectsRenderer::drawCloakEffectIntoBackgroundBuffer(). This is
+   * needed when other effects are applied to the background buffer later.
+   * Otherwise, they are left out, and need to be drawn using
+   * renderCloakedRegularSprites() once the background buffer is complete.
+   */
+  void renderRegularSprites(
+    const SpecialEffectsRenderer& fx,
+    bool drawCloakedSprites) const;
+
+  /** Draw the sprites left out by renderRegularSprites()
+   *
+   * All regular sprites using the cloak effect are drawn in a single batch.
+   * Afterwards, sprites which sort after the first cloaked one are drawn
+   * again on top, to keep the draw order intact.
+   */
+  void renderCloakedRegularSprites(const SpecialEffectsRenderer& fx) const;
+
+  /** Draw all top-most sprites
+   *
+   * Sprites using the cloak effect are drawn in a single batch, in the same
+   * way as for renderCloakedRegularSprites().
+   */
   void renderForegroundSprites(const SpecialEffectsRenderer& fx) const;
 
 private:
-  void renderSprite(
-    const SpriteDrawSpec& spec,
+  using SpriteIter = std::vector<SpriteDrawSpec>::const_iterator;
+
+  SpriteIter firstCloakedSprite(SpriteIter first, SpriteIter last) const;
+  void renderNonCloakedSprites(SpriteIter first, SpriteIter last) const;
+  void renderSprite(const SpriteDrawSpec& spec) const;
+  void renderCloakedSprites(
+    SpriteIter first,
+    SpriteIter last,
     const SpecialEffectsRenderer& fx) const;
 
   // Temporary storage used for sorting sprites by draw order during sprite
@@ -105,11 +166,22 @@ private:
   std::vector<SortableDrawSpec> mSortBuffer;
 
   // Data needed to draw sprites that are currently visible. This is updated
-  // by each call to update().
+  // by each call to update() which actually collects sprites. The motion
+  // data is kept in a separate array, index-aligned with mSprites.
   std::vector<SpriteDrawSpec> mSprites;
+  std::vector<SpriteMotion> mSpriteMotions;
   std::vector<SpriteDrawSpec>::iterator miForegroundSprites;
   bool mCloakEffectSpritesVisible = false;
 
+  // Inputs of the last sprite collection
+  base::Size mViewportSize;
+  base::Vec2 mCameraPosition;
+  bool mSpritesOutdated = true;
+
+  // Temporary storage for batching up sprites using the cloak effect, reused
+  // for the same reason as mSortBuffer.
+  mutable std::vector<CloakEffectSprite> mCloakEffectSprites;
+
   // Dependencies needed for drawing
   renderer::Renderer* mpRenderer;
   const renderer::TextureAtlas* mpTextureAtlas;
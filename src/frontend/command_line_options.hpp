@@ -45,7 +45,10 @@ struct CommandLineOptions
   bool mDebugModeEnabled = false;
   bool mDisableAudio = false;
   bool mPlayDemo = false;
+  bool mPreloadAllSprites = false;
   std::optional<base::Vec2> mPlayerPosition;
+  std::string mFrameCapturePath;
+  int mFrameSpikeThresholdMs = 100;
 };
 
 } // namespace rigel
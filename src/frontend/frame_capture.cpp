@@ -0,0 +1,172 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_capture.hpp"
+
+#include "base/tracing.hpp"
+#include "renderer/renderer.hpp"
+
+#include <loguru.hpp>
+
+#include <string>
+#include <utility>
+
+
+namespace rigel
+{
+
+namespace fs = std::filesystem;
+
+
+FrameCapture::FrameCapture(
+  renderer::Renderer* pRenderer,
+  fs::path outputDirectory)
+  : mpRenderer(pRenderer)
+  , mOutputDirectory(std::move(outputDirectory))
+{
+  std::error_code ec;
+  fs::create_directories(mOutputDirectory, ec);
+
+  LOG_F(INFO, "Capturing frames to %s", mOutputDirectory.u8string().c_str());
+}
+
+
+FrameCapture::~FrameCapture()
+{
+  // Frames which are still being read back by the renderer at this point are
+  // lost, but everything that has made it into the writer's queue is written.
+  mWriter.waitUntilIdle();
+
+  if (mCurrentFile.is_open())
+  {
+    mCurrentFile.close();
+    if (!mCurrentFile)
+    {
+      mWriteFailed = true;
+      LOG_F(ERROR, "Failed to finish writing captured frames");
+    }
+  }
+
+  if (mWriteFailed)
+  {
+    LOG_F(
+      ERROR,
+      "Frame capture stopped due to errors: %llu frames written",
+      static_cast<unsigned long long>(mNumFramesWritten));
+  }
+  else
+  {
+    LOG_F(
+      INFO,
+      "Frame capture finished: %llu frames",
+      static_cast<unsigned long long>(mNumFramesWritten));
+  }
+}
+
+
+void FrameCapture::captureFrame()
+{
+  RIGEL_TRACE_FUNCTION();
+
+  if (mWriteFailed)
+  {
+    return;
+  }
+
+  mpRenderer->grabCurrentFramebufferAsync([this](data::Image image) {
+    // Wait for the writer instead of dropping frames when it's falling
+    // behind. Dropping would depend on disk and thread timing, making
+    // recordings of the same run differ from each other.
+    {
+      RIGEL_TRACE_SCOPE("FrameCapture::waitForWriter");
+      mWriter.waitUntilPendingCountBelow(MAX_QUEUED_FRAMES);
+    }
+
+    mWriter.post([this, image = std::move(image)]() { writeFrame(image); });
+  });
+}
+
+
+void FrameCapture::writeFrame(const data::Image& bottomUpImage)
+{
+  RIGEL_TRACE_FUNCTION();
+
+  if (mWriteFailed)
+  {
+    return;
+  }
+
+  const auto size = base::Size{
+    static_cast<int>(bottomUpImage.width()),
+    static_cast<int>(bottomUpImage.height())};
+
+  if (!mCurrentFile.is_open() || size != mCurrentFileFrameSize)
+  {
+    const auto filename = "frames_" + std::to_string(mNumFilesWritten) + "_" +
+      std::to_string(size.width) + "x" + std::to_string(size.height) +
+      ".rgba";
+
+    if (mCurrentFile.is_open())
+    {
+      mCurrentFile.close();
+      if (!mCurrentFile)
+      {
+        LOG_F(ERROR, "Failed to write captured frames, stopping capture");
+        mWriteFailed = true;
+        return;
+      }
+    }
+
+    const auto filePath = mOutputDirectory / filename;
+    mCurrentFile.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!mCurrentFile)
+    {
+      LOG_F(
+        ERROR,
+        "Failed to open %s, stopping capture",
+        filePath.u8string().c_str());
+      mWriteFailed = true;
+      return;
+    }
+
+    mCurrentFileFrameSize = size;
+    ++mNumFilesWritten;
+  }
+
+  // Read back images are upside down, so we write the rows in reverse order
+  // instead of flipping the image first.
+  const auto& pixels = bottomUpImage.pixelData();
+  const auto rowSizeInBytes =
+    static_cast<std::streamsize>(size.width * sizeof(data::Pixel));
+
+  for (auto y = size.height - 1; y >= 0; --y)
+  {
+    mCurrentFile.write(
+      reinterpret_cast<const char*>(pixels.data() + y * size.width),
+      rowSizeInBytes);
+  }
+
+  if (!mCurrentFile)
+  {
+    LOG_F(ERROR, "Failed to write captured frame, stopping capture");
+    mWriteFailed = true;
+    return;
+  }
+
+  ++mNumFramesWritten;
+}
+
+} // namespace rigel
@@ -0,0 +1,96 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/image.hpp"
+#include "base/spatial_types.hpp"
+#include "base/worker_thread.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+
+namespace rigel::renderer
+{
+class Renderer;
+}
+
+
+namespace rigel
+{
+
+/** Records presented frames to disk, for producing videos offline
+ *
+ * Each frame is read back asynchronously via
+ * Renderer::grabCurrentFramebufferAsync(), and written out by a background
+ * thread as uncompressed RGBA data. All frames with the same resolution go
+ * into one file, named frames_<N>_<width>x<height>.rgba, which can be
+ * converted into a video with tools like ffmpeg:
+ *
+ *   ffmpeg -f rawvideo -pixel_format rgba -video_size <width>x<height>
+ *     -framerate 60 -i frames_0_<width>x<height>.rgba output.mkv
+ *
+ * At most MAX_QUEUED_FRAMES frames wait to be written at any time. If the
+ * writer can't keep up, capturing blocks the main thread until there is room
+ * in the queue again. Frames are never dropped, so recording the same
+ * deterministic run twice (e.g. a demo) produces the same sequence of frames.
+ *
+ * If writing to disk fails, the error is logged and capturing stops.
+ */
+class FrameCapture
+{
+public:
+  static constexpr auto MAX_QUEUED_FRAMES = std::size_t{8};
+
+  FrameCapture(
+    renderer::Renderer* pRenderer,
+    std::filesystem::path outputDirectory);
+  ~FrameCapture();
+
+  FrameCapture(const FrameCapture&) = delete;
+  FrameCapture& operator=(const FrameCapture&) = delete;
+
+  /** Capture current framebuffer contents
+   *
+   * Must be called right before presenting, i.e. before
+   * Renderer::swapBuffers().
+   */
+  void captureFrame();
+
+private:
+  void writeFrame(const data::Image& bottomUpImage);
+
+  renderer::Renderer* mpRenderer;
+  std::filesystem::path mOutputDirectory;
+
+  // Set by the writer thread when writing fails, which stops the capture
+  std::atomic<bool> mWriteFailed = false;
+
+  // Only accessed by the writer thread
+  std::ofstream mCurrentFile;
+  base::Size mCurrentFileFrameSize;
+  std::uint64_t mNumFramesWritten = 0;
+  int mNumFilesWritten = 0;
+
+  // Declared last, so that all queued frames are written before the rest
+  // of the members are destroyed
+  base::WorkerThread mWriter{"Frame capture writer"};
+};
+
+} // namespace rigel
@@ -0,0 +1,110 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_spike_detector.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+
+namespace rigel
+{
+
+namespace
+{
+
+float secondsSince(
+  const base::Clock::time_point start,
+  const base::Clock::time_point end)
+{
+  return std::chrono::duration<float>(end - start).count();
+}
+
+} // namespace
+
+
+FrameSpikeDetector::FrameSpikeDetector(const double thresholdInSeconds)
+  : mFrames()
+  , mThreshold(thresholdInSeconds)
+{
+}
+
+
+void FrameSpikeDetector::beginFrame(const base::Clock::time_point startTime)
+{
+  mFrameStartTime = startTime;
+  mLastPhaseEndTime = startTime;
+  mIgnoreCurrentFrame = false;
+  mFrames[mCurrentFrame] = {};
+}
+
+
+void FrameSpikeDetector::endPhase(const Phase phase)
+{
+  const auto now = base::Clock::now();
+  mFrames[mCurrentFrame].mPhaseTimes[static_cast<int>(phase)] +=
+    secondsSince(mLastPhaseEndTime, now);
+  mLastPhaseEndTime = now;
+}
+
+
+bool FrameSpikeDetector::endFrame()
+{
+  auto& frame = mFrames[mCurrentFrame];
+  frame.mTotalTime = secondsSince(mFrameStartTime, base::Clock::now());
+
+  mCurrentFrame = (mCurrentFrame + 1) % NUM_RECORDED_FRAMES;
+  mNumRecordedFrames = std::min(mNumRecordedFrames + 1, NUM_RECORDED_FRAMES);
+  ++mFramesSinceLastSpike;
+
+  const auto isSpike = mThreshold > 0.0 && !mIgnoreCurrentFrame &&
+    frame.mTotalTime > mThreshold &&
+    mFramesSinceLastSpike >= NUM_RECORDED_FRAMES;
+  if (isSpike)
+  {
+    mFramesSinceLastSpike = 0;
+  }
+
+  return isSpike;
+}
+
+
+void FrameSpikeDetector::printReport(std::ostream& stream) const
+{
+  const auto toMs = [](const float seconds) { return seconds * 1000.0f; };
+
+  stream << "Timings of the last " << mNumRecordedFrames
+         << " frames in ms (events, update & render, present, fps limiter,"
+         << " total):\n";
+
+  const auto firstFrame =
+    (mCurrentFrame - mNumRecordedFrames + NUM_RECORDED_FRAMES) %
+    NUM_RECORDED_FRAMES;
+  for (auto i = 0; i < mNumRecordedFrames; ++i)
+  {
+    const auto& frame = mFrames[(firstFrame + i) % NUM_RECORDED_FRAMES];
+
+    stream << std::fixed << std::setprecision(2);
+    for (const auto phaseTime : frame.mPhaseTimes)
+    {
+      stream << std::setw(8) << toMs(phaseTime);
+    }
+    stream << std::setw(9) << toMs(frame.mTotalTime) << '\n';
+  }
+}
+
+} // namespace rigel
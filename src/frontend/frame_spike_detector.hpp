@@ -0,0 +1,94 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/clock.hpp"
+
+#include <array>
+#include <iosfwd>
+
+
+namespace rigel
+{
+
+/** Detects unusually long frames, for diagnosing stutter
+ *
+ * The time spent in each phase of a frame is recorded into a ring buffer
+ * holding the most recent frames. When a frame takes longer than the given
+ * threshold, endFrame() returns true. printReport() can then be used to
+ * output the recorded timings, which show what led up to the long frame.
+ *
+ * Recording only costs a few clock reads per frame, so this can be left
+ * enabled all the time.
+ */
+class FrameSpikeDetector
+{
+public:
+  enum class Phase
+  {
+    Events,
+    UpdateAndRender,
+    Present,
+    FpsLimiter
+  };
+
+  static constexpr auto NUM_PHASES = 4;
+  static constexpr auto NUM_RECORDED_FRAMES = 64;
+
+  /** A threshold of 0 or less disables detection */
+  explicit FrameSpikeDetector(double thresholdInSeconds);
+
+  void beginFrame(base::Clock::time_point startTime);
+
+  /** Mark the end of a phase of the current frame
+   *
+   * All time since the end of the previous phase, or the start of the frame,
+   * is attributed to the given phase.
+   */
+  void endPhase(Phase phase);
+
+  /** Exclude the current frame from detection, e.g. due to loading */
+  void ignoreCurrentFrame() { mIgnoreCurrentFrame = true; }
+
+  /** Finish recording the current frame
+   *
+   * Returns true if the frame took longer than the threshold. To avoid
+   * flooding the log, this only happens again once all recorded frames have
+   * been replaced by newer ones.
+   */
+  bool endFrame();
+
+  void printReport(std::ostream& stream) const;
+
+private:
+  struct FrameTimings
+  {
+    std::array<float, NUM_PHASES> mPhaseTimes;
+    float mTotalTime;
+  };
+
+  std::array<FrameTimings, NUM_RECORDED_FRAMES> mFrames;
+  int mCurrentFrame = 0;
+  int mNumRecordedFrames = 0;
+  int mFramesSinceLastSpike = NUM_RECORDED_FRAMES;
+  base::Clock::time_point mFrameStartTime;
+  base::Clock::time_point mLastPhaseEndTime;
+  double mThreshold;
+  bool mIgnoreCurrentFrame = false;
+};
+
+} // namespace rigel
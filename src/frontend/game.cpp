@@ -20,6 +20,7 @@
 #include "assets/png_image.hpp"
 #include "base/defer.hpp"
 #include "base/math_utils.hpp"
+#include "base/tracing.hpp"
 #include "data/duke_script.hpp"
 #include "data/game_traits.hpp"
 #include "engine/timing.hpp"
@@ -39,6 +40,7 @@ RIGEL_DISABLE_WARNINGS
 RIGEL_RESTORE_WARNINGS
 
 #include <ctime>
+#include <sstream>
 
 
 namespace rigel
@@ -254,8 +256,14 @@ Game::Game(
         &mRenderer,
         mResources.loadUiSpriteSheet(data::GameTraits::INGAME_PALETTE)},
       &mRenderer)
-  , mSpriteFactory(&mRenderer, &mResources)
+  , mSpriteFactory(
+      &mRenderer,
+      &mResources,
+      commandLineOptions.mPreloadAllSprites
+        ? engine::SpriteFactory::LoadingMode::Eager
+        : engine::SpriteFactory::LoadingMode::OnDemand)
   , mTextRenderer(&mUiSpriteSheet, &mRenderer, mResources)
+  , mFrameSpikeDetector(commandLineOptions.mFrameSpikeThresholdMs / 1000.0)
 {
   LOG_F(INFO, "Successfully loaded all resources");
   LOG_F(
@@ -266,6 +274,16 @@ Game::Game(
 
   mCommandLineOptions.mSkipIntro |= mpUserProfile->mOptions.mSkipIntro;
 
+  if (!mCommandLineOptions.mFrameCapturePath.empty())
+  {
+    mFrameCapture.emplace(&mRenderer, mCommandLineOptions.mFrameCapturePath);
+  }
+
+  // Files in enabled mods might have been added or removed when the user
+  // triggers a rescan in the options menu
+  mpUserProfile->mModLibrary.setRescanHook(
+    [this]() { mResources.rescanModFiles(); });
+
   applyChangedOptions();
 
   mpCurrentGameMode = wrapWithInitialFadeIn(createInitialGameMode(
@@ -280,17 +298,34 @@ Game::Game(
 }
 
 
+Game::~Game()
+{
+  mpUserProfile->mModLibrary.setRescanHook({});
+}
+
+
 auto Game::runOneFrame() -> std::optional<StopReason>
 {
   using namespace std::chrono;
   using base::defer;
 
+  RIGEL_TRACE_SCOPE("Game::runOneFrame");
+
   const auto startOfFrame = base::Clock::now();
   const auto elapsed =
     duration<entityx::TimeDelta>(startOfFrame - mLastTime).count();
   mLastTime = startOfFrame;
 
+  mFrameSpikeDetector.beginFrame(startOfFrame);
+
+  // Waiting for events while minimized isn't a performance problem
+  if (mIsMinimized)
+  {
+    mFrameSpikeDetector.ignoreCurrentFrame();
+  }
+
   pumpEvents();
+  mFrameSpikeDetector.endPhase(FrameSpikeDetector::Phase::Events);
   if (!mIsRunning)
   {
     stopMusic();
@@ -303,7 +338,6 @@ auto Game::runOneFrame() -> std::optional<StopReason>
     ImGui::SetMouseCursor(ImGuiMouseCursor_None);
 
     updateAndRender(elapsed);
-    mEventQueue.clear();
   }
 
   if (mScreenshotRequested)
@@ -312,8 +346,20 @@ auto Game::runOneFrame() -> std::optional<StopReason>
     mScreenshotRequested = false;
   }
 
+  if (mFrameCapture)
+  {
+    mFrameCapture->captureFrame();
+  }
+
+  mFrameSpikeDetector.endPhase(FrameSpikeDetector::Phase::UpdateAndRender);
+
   swapBuffers();
 
+  if (mFrameSpikeDetector.endFrame())
+  {
+    reportFrameSpike();
+  }
+
   const auto changedOptionsRequireRestart = applyChangedOptions();
 
   if (!mGamePathToSwitchTo.empty())
@@ -336,6 +382,8 @@ auto Game::runOneFrame() -> std::optional<StopReason>
 
 void Game::pumpEvents()
 {
+  RIGEL_TRACE_FUNCTION();
+
   SDL_Event event;
   while (mIsMinimized && SDL_WaitEvent(&event))
   {
@@ -357,37 +405,59 @@ void Game::pumpEvents()
 
 void Game::updateAndRender(const entityx::TimeDelta elapsed)
 {
-  mCurrentFrameIsWidescreen = false;
-
-  auto pMaybeNextMode = std::invoke([&]() {
-    auto saved = mUpscalingBuffer.bindAndClear(
-      mpUserProfile->mOptions.mPerElementUpscalingEnabled);
-    return mpCurrentGameMode->updateAndRender(elapsed, mEventQueue);
-  });
+  RIGEL_TRACE_FUNCTION();
 
-  if (pMaybeNextMode)
+  // While a screen fade is in progress, the game mode is paused. Any input
+  // events are kept in the queue, and delivered once the fade is done.
+  if (mPendingScreenFades.empty())
   {
-    fadeOutScreen();
+    mCurrentFrameIsWidescreen = false;
 
-    setPerElementUpscalingEnabled(pMaybeNextMode->needsPerElementUpscaling());
-    mpCurrentGameMode = std::move(pMaybeNextMode);
-
-    {
+    auto pMaybeNextMode = std::invoke([&]() {
       auto saved = mUpscalingBuffer.bindAndClear(
         mpUserProfile->mOptions.mPerElementUpscalingEnabled);
-      mpCurrentGameMode->updateAndRender(0, {});
-    }
+      return mpCurrentGameMode->updateAndRender(elapsed, mEventQueue);
+    });
+
+    mEventQueue.clear();
+
+    if (pMaybeNextMode)
+    {
+      fadeOutScreen();
+
+      // Switching modes involves loading, so a long frame is expected here
+      markCurrentFrameAsLoading();
+
+      setPerElementUpscalingEnabled(pMaybeNextMode->needsPerElementUpscaling());
+      mpCurrentGameMode = std::move(pMaybeNextMode);
+
+      {
+        auto saved = mUpscalingBuffer.bindAndClear(
+          mpUserProfile->mOptions.mPerElementUpscalingEnabled);
+        mpCurrentGameMode->updateAndRender(0, {});
+      }
 
-    fadeInScreen();
+      fadeInScreen();
+    }
   }
 
-  mUpscalingBuffer.present(
-    mCurrentFrameIsWidescreen,
-    mpUserProfile->mOptions.mPerElementUpscalingEnabled);
+  if (!mPendingScreenFades.empty())
+  {
+    updateScreenFade();
+  }
+  else
+  {
+    mUpscalingBuffer.present(
+      mCurrentFrameIsWidescreen,
+      mpUserProfile->mOptions.mPerElementUpscalingEnabled);
+  }
 
   if (mpUserProfile->mOptions.mShowFpsCounter)
   {
-    mFpsDisplay.updateAndRender(elapsed);
+    mFpsDisplay.updateAndRender(
+      elapsed,
+      mFpsLimiter ? std::optional{mFpsLimiter->frameTimeStats()}
+                  : std::nullopt);
   }
 }
 
@@ -479,65 +549,89 @@ bool Game::handleEvent(const SDL_Event& event)
 }
 
 
-void Game::performScreenFadeBlocking(const FadeType type)
+bool Game::screenIsFadedOut() const
 {
-#ifdef __EMSCRIPTEN__
-  // TODO: Implement screen fades for the Emscripten version.
-  // This is not so easy because we can't simply do a loop that renders
-  // multiple frames when running in the browser, as it just blocks the
-  // browser's main thread and the intermediate (faded) frames are not
-  // shown until the current requestAnimationFrame() callback returns.
-  // So we'd need to either find a way to suspend and then resume C++ code
-  // execution during the fade, or rewrite all client code to be stateful
-  // instead of relying on a blocking fade() function.
-  mUpscalingBuffer.setAlphaMod(type == FadeType::In ? 255 : 0);
-#else
-  using namespace std::chrono;
+  if (!mPendingScreenFades.empty())
+  {
+    return mPendingScreenFades.back() == FadeType::Out;
+  }
+
+  return mUpscalingBuffer.alphaMod() == 0;
+}
 
-  auto saved = renderer::saveState(&mRenderer);
-  mRenderer.resetState();
 
-  auto startTime = base::Clock::now();
+void Game::updateScreenFade()
+{
+  RIGEL_TRACE_FUNCTION();
 
-  while (mIsRunning)
+  using namespace std::chrono;
+
+  // The fade starts on the first frame where it's shown, so that any time
+  // spent in the frame which requested it doesn't count towards the fade.
+  const auto now = base::Clock::now();
+  if (!moScreenFadeStartTime)
   {
-    const auto now = base::Clock::now();
-    const auto elapsedTime = duration<double>(now - startTime).count();
-    const auto fastTicksElapsed = engine::timeToFastTicks(elapsedTime);
-    const auto fadeFactor =
-      std::clamp((fastTicksElapsed / 4.0) / 16.0, 0.0, 1.0);
-    const auto alpha = type == FadeType::In ? fadeFactor : 1.0 - fadeFactor;
-    const auto alphaMod = base::roundTo<std::uint8_t>(255.0 * alpha);
+    moScreenFadeStartTime = now;
+  }
+
+  const auto type = mPendingScreenFades.front();
+  const auto elapsedTime = duration<double>(now - *moScreenFadeStartTime);
+  const auto fastTicksElapsed = engine::timeToFastTicks(elapsedTime.count());
+  const auto fadeFactor = std::clamp((fastTicksElapsed / 4.0) / 16.0, 0.0, 1.0);
+  const auto alpha = type == FadeType::In ? fadeFactor : 1.0 - fadeFactor;
 
-    mUpscalingBuffer.setAlphaMod(alphaMod);
+  mUpscalingBuffer.setAlphaMod(base::roundTo<std::uint8_t>(255.0 * alpha));
+
+  if (type == FadeType::Out)
+  {
+    mUpscalingBuffer.presentPreservedContents(
+      mPreservedFrameIsWidescreen,
+      mpUserProfile->mOptions.mPerElementUpscalingEnabled);
+  }
+  else
+  {
     mUpscalingBuffer.present(
       mCurrentFrameIsWidescreen,
       mpUserProfile->mOptions.mPerElementUpscalingEnabled);
-    swapBuffers();
-
-    if (fadeFactor >= 1.0)
-    {
-      break;
-    }
   }
 
-  // Pretend that the fade didn't take any time
-  mLastTime = base::Clock::now();
-#endif
+  if (fadeFactor >= 1.0)
+  {
+    mPendingScreenFades.erase(mPendingScreenFades.begin());
+    moScreenFadeStartTime.reset();
+  }
 }
 
 
 void Game::swapBuffers()
 {
-  mRenderer.swapBuffers();
+  const auto swapStartTime = base::Clock::now();
+
+  {
+    RIGEL_TRACE_SCOPE("Renderer::swapBuffers");
+    mRenderer.swapBuffers();
+  }
+
+  mFrameSpikeDetector.endPhase(FrameSpikeDetector::Phase::Present);
 
   if (mFpsLimiter)
   {
-    mFpsLimiter->updateAndWait();
+    mFpsLimiter->updateAndWait(base::Clock::now() - swapStartTime);
+    mFrameSpikeDetector.endPhase(FrameSpikeDetector::Phase::FpsLimiter);
   }
 }
 
 
+void Game::reportFrameSpike()
+{
+  std::stringstream report;
+  mFrameSpikeDetector.printReport(report);
+  mpCurrentGameMode->printDebugText(report);
+
+  LOG_F(WARNING, "Frame took unusually long\n%s", report.str().c_str());
+}
+
+
 bool Game::applyChangedOptions()
 {
   const auto& currentOptions = mpUserProfile->mOptions;
@@ -706,14 +800,21 @@ void Game::enumerateGameControllers()
 
 void Game::takeScreenshot()
 {
+  RIGEL_TRACE_FUNCTION();
+
   namespace fs = std::filesystem;
 
   constexpr auto SCREENSHOTS_SUBDIR = "screenshots";
 
-  const auto shot = mRenderer.grabCurrentFramebuffer();
-  const auto filename = makeScreenshotFilename();
+  const auto gameDirScreenshotPath =
+    effectiveGamePath(mCommandLineOptions, *mpUserProfile) / SCREENSHOTS_SUBDIR;
+  const auto maybePrefsDir = createOrGetPreferencesPath();
+  const auto prefsDirScreenshotPath = maybePrefsDir
+    ? std::optional<fs::path>{*maybePrefsDir / SCREENSHOTS_SUBDIR}
+    : std::nullopt;
 
-  auto saveShot = [&](const fs::path& path) {
+  auto saveShot = [filename = makeScreenshotFilename()](
+                    const fs::path& path, const data::Image& shot) {
     std::error_code ec;
 
     if (!fs::exists(path, ec) && !ec)
@@ -724,20 +825,28 @@ void Game::takeScreenshot()
     return assets::savePng((path / filename).u8string(), shot);
   };
 
-  const auto gameDirScreenshotPath =
-    effectiveGamePath(mCommandLineOptions, *mpUserProfile) / SCREENSHOTS_SUBDIR;
+  // Reading back the framebuffer, as well as encoding and writing the
+  // image are done asynchronously, to avoid a visible hitch.
+  mRenderer.grabCurrentFramebufferAsync(
+    [=, pWorker = &mBackgroundWorker](data::Image rawShot) {
+      pWorker->post([=, rawShot = std::move(rawShot)]() {
+        RIGEL_TRACE_SCOPE("Game::saveScreenshot");
 
-  // First, try the game dir.
-  if (saveShot(gameDirScreenshotPath))
-  {
-    return;
-  }
+        const auto shot = rawShot.flipped();
 
-  // If the game dir is not writable, try the user profile dir.
-  if (const auto maybePrefsDir = createOrGetPreferencesPath(); maybePrefsDir)
-  {
-    saveShot(*maybePrefsDir / SCREENSHOTS_SUBDIR);
-  }
+        // First, try the game dir.
+        if (saveShot(gameDirScreenshotPath, shot))
+        {
+          return;
+        }
+
+        // If the game dir is not writable, try the user profile dir.
+        if (prefsDirScreenshotPath)
+        {
+          saveShot(*prefsDirScreenshotPath, shot);
+        }
+      });
+    });
 }
 
 
@@ -752,13 +861,27 @@ void Game::setPerElementUpscalingEnabled(bool enabled)
 
 void Game::fadeOutScreen()
 {
-  if (mUpscalingBuffer.alphaMod() == 0)
+  if (screenIsFadedOut())
   {
     // Already faded out
     return;
   }
 
-  performScreenFadeBlocking(FadeType::Out);
+  if (!mPendingScreenFades.empty())
+  {
+    // A fade-in was requested earlier during this frame. Fading in and then
+    // right back out again would only flash up whatever was rendered in
+    // between, so we cancel out both fades instead.
+    mPendingScreenFades.pop_back();
+  }
+  else
+  {
+    // The client might render the next screen right away, so we need to
+    // keep a copy of the current contents for fading them out.
+    mUpscalingBuffer.preserveContents();
+    mPreservedFrameIsWidescreen = mCurrentFrameIsWidescreen;
+    mPendingScreenFades.push_back(FadeType::Out);
+  }
 
   // Clear render canvas after a fade-out
   mUpscalingBuffer.clear();
@@ -769,13 +892,13 @@ void Game::fadeOutScreen()
 
 void Game::fadeInScreen()
 {
-  if (mUpscalingBuffer.alphaMod() == 255)
+  if (!screenIsFadedOut())
   {
     // Already faded in
     return;
   }
 
-  performScreenFadeBlocking(FadeType::In);
+  mPendingScreenFades.push_back(FadeType::In);
 }
 
 
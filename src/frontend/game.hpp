@@ -22,8 +22,11 @@
 #include "base/clock.hpp"
 #include "base/spatial_types.hpp"
 #include "base/warnings.hpp"
+#include "base/worker_thread.hpp"
 #include "engine/sprite_factory.hpp"
 #include "engine/tiled_texture.hpp"
+#include "frontend/frame_capture.hpp"
+#include "frontend/frame_spike_detector.hpp"
 #include "frontend/game_mode.hpp"
 #include "frontend/game_service_provider.hpp"
 #include "frontend/user_profile.hpp"
@@ -41,6 +44,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 
 namespace rigel
@@ -72,6 +76,7 @@ public:
     UserProfile* pUserProfile,
     SDL_Window* pWindow,
     bool isFirstLaunch);
+  ~Game();
   Game(const Game&) = delete;
   Game& operator=(const Game&) = delete;
 
@@ -103,9 +108,11 @@ private:
 
   bool handleEvent(const SDL_Event& event);
 
-  void performScreenFadeBlocking(FadeType type);
+  bool screenIsFadedOut() const;
+  void updateScreenFade();
 
   void swapBuffers();
+  void reportFrameSpike();
   bool applyChangedOptions();
   void enumerateGameControllers();
   void takeScreenshot();
@@ -129,6 +136,11 @@ private:
     mCurrentFrameIsWidescreen = true;
   }
 
+  void markCurrentFrameAsLoading() override
+  {
+    mFrameSpikeDetector.ignoreCurrentFrame();
+  }
+
   bool isSharewareVersion() const override { return mIsShareWareVersion; }
 
   const CommandLineOptions& commandLineOptions() const override
@@ -152,6 +164,12 @@ private:
   renderer::UpscalingBuffer mUpscalingBuffer;
   bool mCurrentFrameIsWidescreen = false;
 
+  // Screen fades requested by the client code are played back over the
+  // following frames, with the game mode paused until they are done.
+  std::vector<FadeType> mPendingScreenFades;
+  std::optional<base::Clock::time_point> moScreenFadeStartTime;
+  bool mPreservedFrameIsWidescreen = false;
+
   std::unique_ptr<GameMode> mpCurrentGameMode;
 
   bool mIsRunning;
@@ -175,6 +193,12 @@ private:
   std::vector<SDL_Event> mEventQueue;
 
   GameControllerInfo mGameControllerInfo;
+  std::optional<FrameCapture> mFrameCapture;
+  FrameSpikeDetector mFrameSpikeDetector;
+
+  // Declared last, so that any outstanding work is completed before
+  // the rest of the game is torn down
+  base::WorkerThread mBackgroundWorker{"Background worker"};
 };
 
 } // namespace rigel
@@ -25,6 +25,7 @@ RIGEL_DISABLE_WARNINGS
 #include <SDL_events.h>
 RIGEL_RESTORE_WARNINGS
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 
@@ -76,6 +77,9 @@ struct GameMode
     const std::vector<SDL_Event>& events) = 0;
 
   virtual bool needsPerElementUpscaling() const { return false; }
+
+  /** Print information about the mode's current state, for diagnostics */
+  virtual void printDebugText(std::ostream&) const {}
 };
 
 
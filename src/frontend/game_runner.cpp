@@ -17,6 +17,7 @@
 #include "game_runner.hpp"
 
 #include "base/math_utils.hpp"
+#include "base/tracing.hpp"
 #include "frontend/game_service_provider.hpp"
 #include "frontend/user_profile.hpp"
 #include "game_logic/world_state.hpp"
@@ -33,14 +34,17 @@ GameRunner::GameRunner(
   const data::GameSessionId& sessionId,
   GameMode::Context context,
   const std::optional<base::Vec2> playerPositionOverride,
-  const bool showWelcomeMessage)
+  const bool showWelcomeMessage,
+  std::optional<game_logic::PreloadedLevel> preloadedLevel)
   : mContext(context)
   , mWorld(
       pPlayerModel,
       sessionId,
       context,
       playerPositionOverride,
-      showWelcomeMessage)
+      showWelcomeMessage,
+      game_logic::PlayerInput{},
+      std::move(preloadedLevel))
   , mInputHandler(&context.mpUserProfile->mOptions)
   , mMenu(context, pPlayerModel, &mWorld, sessionId)
 {
@@ -117,6 +121,12 @@ bool GameRunner::needsPerElementUpscaling() const
 }
 
 
+void GameRunner::printDebugText(std::ostream& stream) const
+{
+  mWorld.printDebugText(stream);
+}
+
+
 float GameRunner::interpolationFactor(const engine::TimeDelta dt) const
 {
   return mContext.mpUserProfile->mOptions.mMotionSmoothing
@@ -127,7 +137,10 @@ float GameRunner::interpolationFactor(const engine::TimeDelta dt) const
 
 void GameRunner::updateWorld(const engine::TimeDelta dt)
 {
+  RIGEL_TRACE_SCOPE("GameRunner::updateWorld");
+
   auto update = [this]() {
+    RIGEL_TRACE_SCOPE("GameWorld::updateGameLogic");
     mWorld.updateGameLogic(mInputHandler.fetchInput());
   };
 
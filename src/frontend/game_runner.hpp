@@ -42,11 +42,13 @@ public:
     const data::GameSessionId& sessionId,
     GameMode::Context context,
     std::optional<base::Vec2> playerPositionOverride = std::nullopt,
-    bool showWelcomeMessage = false);
+    bool showWelcomeMessage = false,
+    std::optional<game_logic::PreloadedLevel> preloadedLevel = std::nullopt);
 
   void handleEvent(const SDL_Event& event);
   void updateAndRender(engine::TimeDelta dt);
   bool needsPerElementUpscaling() const;
+  void printDebugText(std::ostream& stream) const;
 
   bool levelFinished() const;
   bool gameQuit() const;
@@ -62,11 +62,13 @@ struct IGameServiceProvider
 {
   virtual ~IGameServiceProvider() = default;
 
-  // Blocking calls
+  // Screen fades are played back after the current frame, with the current
+  // game mode paused until they are done. Whatever was rendered before
+  // requesting a fade-out is faded out, and whatever is rendered by the end
+  // of the frame is faded in.
   virtual void fadeOutScreen() = 0;
   virtual void fadeInScreen() = 0;
 
-  // Non-blocking calls
   virtual void playSound(data::SoundId id) = 0;
   virtual void stopSound(data::SoundId id) = 0;
   virtual void stopAllSounds() = 0;
@@ -75,6 +77,12 @@ struct IGameServiceProvider
   virtual void scheduleGameQuit() = 0;
   virtual void switchGamePath(const std::filesystem::path& newGamePath) = 0;
   virtual void markCurrentFrameAsWidescreen() = 0;
+
+  // Excludes the current frame from frame spike detection. Game modes should
+  // call this when doing expensive work like loading a level, which is
+  // expected to take longer than a regular frame.
+  virtual void markCurrentFrameAsLoading() = 0;
+
   virtual bool isSharewareVersion() const = 0;
   virtual const CommandLineOptions& commandLineOptions() const = 0;
   virtual const GameControllerInfo& gameControllerInfo() const = 0;
@@ -20,12 +20,19 @@
 #include "menu_mode.hpp"
 
 #include "base/match.hpp"
+#include "base/tracing.hpp"
 #include "data/saved_game.hpp"
 #include "frontend/game_service_provider.hpp"
 #include "frontend/user_profile.hpp"
 #include "ui/high_score_list.hpp"
 #include "ui/menu_navigation.hpp"
 
+RIGEL_DISABLE_WARNINGS
+#include <loguru.hpp>
+RIGEL_RESTORE_WARNINGS
+
+#include <ostream>
+
 
 namespace rigel
 {
@@ -67,14 +74,16 @@ GameSessionMode::GameSessionMode(const data::SavedGame& save, Context context)
 GameSessionMode::GameSessionMode(
   const data::GameSessionId& sessionId,
   data::PlayerModel playerModel,
-  Context context)
+  Context context,
+  std::optional<game_logic::PreloadedLevel> preloadedLevel)
   : mPlayerModel(std::move(playerModel))
   , mCurrentStage(std::make_unique<GameRunner>(
       &mPlayerModel,
       sessionId,
       context,
       std::nullopt,
-      false /* don't show welcome message */))
+      false /* don't show welcome message */,
+      std::move(preloadedLevel)))
   , mEpisode(sessionId.mEpisode)
   , mCurrentLevelNr(sessionId.mLevel)
   , mDifficulty(sessionId.mDifficulty)
@@ -163,6 +172,7 @@ std::unique_ptr<GameMode> GameSessionMode::updateAndRender(
 
           auto endScreens = ui::EpisodeEndSequence{
             mContext, mEpisode, achievedBonuses, scoreWithoutBonuses};
+          mContext.mpServiceProvider->markCurrentFrameAsLoading();
           mContext.mpServiceProvider->fadeOutScreen();
           mCurrentStage = std::move(endScreens);
         }
@@ -173,6 +183,11 @@ std::unique_ptr<GameMode> GameSessionMode::updateAndRender(
           auto bonusScreen =
             ui::BonusScreen{mContext, achievedBonuses, scoreWithoutBonuses};
 
+          // Decode the next level while the bonus screen is shown, so that
+          // only GPU uploads and entity creation are left to do once we
+          // switch over to it.
+          startPreloadingNextLevel();
+
           fadeToNewStage(bonusScreen);
           mCurrentStage = std::move(bonusScreen);
         }
@@ -204,7 +219,8 @@ std::unique_ptr<GameMode> GameSessionMode::updateAndRender(
         return std::unique_ptr<GameSessionMode>{new GameSessionMode{
           data::GameSessionId{mEpisode, ++mCurrentLevelNr, mDifficulty},
           mPlayerModel,
-          mContext}};
+          mContext,
+          takePreloadedNextLevel()}};
       }
 
       return nullptr;
@@ -254,9 +270,77 @@ bool GameSessionMode::needsPerElementUpscaling() const
 }
 
 
+void GameSessionMode::printDebugText(std::ostream& stream) const
+{
+  stream << "Episode: " << mEpisode + 1 << ", level: " << mCurrentLevelNr + 1
+         << '\n';
+
+  if (const auto ppIngameMode =
+        std::get_if<std::unique_ptr<GameRunner>>(&mCurrentStage))
+  {
+    (*ppIngameMode)->printDebugText(stream);
+  }
+}
+
+
+void GameSessionMode::startPreloadingNextLevel()
+{
+  const auto nextSessionId =
+    data::GameSessionId{mEpisode, mCurrentLevelNr + 1, mDifficulty};
+  const auto pResources = mContext.mpResources;
+
+  auto pPromise = std::make_shared<std::promise<game_logic::PreloadedLevel>>();
+  mPreloadedNextLevel = pPromise->get_future();
+
+  if (!mpLevelPreloader)
+  {
+    mpLevelPreloader = std::make_unique<base::WorkerThread>("Level preloader");
+  }
+
+  mpLevelPreloader->post([pPromise, pResources, nextSessionId]() {
+    RIGEL_TRACE_SCOPE("Preload level");
+
+    try
+    {
+      pPromise->set_value(game_logic::preloadLevel(*pResources, nextSessionId));
+    }
+    catch (...)
+    {
+      pPromise->set_exception(std::current_exception());
+    }
+  });
+}
+
+
+std::optional<game_logic::PreloadedLevel>
+  GameSessionMode::takePreloadedNextLevel()
+{
+  if (!mPreloadedNextLevel.valid())
+  {
+    return std::nullopt;
+  }
+
+  try
+  {
+    // Usually, the bonus screen takes long enough for this to be ready
+    // already. If not, waiting here is still no worse than loading the level
+    // synchronously.
+    return mPreloadedNextLevel.get();
+  }
+  catch (const std::exception& ex)
+  {
+    // Loading the level again on the main thread will report the error
+    // in the usual way
+    LOG_F(ERROR, "Failed to preload level: %s", ex.what());
+    return std::nullopt;
+  }
+}
+
+
 template <typename StageT>
 void GameSessionMode::fadeToNewStage(StageT& stage)
 {
+  mContext.mpServiceProvider->markCurrentFrameAsLoading();
   mContext.mpServiceProvider->fadeOutScreen();
   stage.updateAndRender(0);
   mContext.mpServiceProvider->fadeInScreen();
@@ -266,6 +350,7 @@ void GameSessionMode::fadeToNewStage(StageT& stage)
 void GameSessionMode::finishGameSession()
 {
   mContext.mpServiceProvider->stopMusic();
+  mContext.mpServiceProvider->markCurrentFrameAsLoading();
   mContext.mpServiceProvider->fadeOutScreen();
 
   const auto scoreQualifies = data::scoreQualifiesForHighScoreList(
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "base/worker_thread.hpp"
 #include "data/player_model.hpp"
 #include "frontend/game_mode.hpp"
 #include "ui/bonus_screen.hpp"
@@ -23,6 +24,8 @@
 
 #include "game_runner.hpp"
 
+#include <future>
+#include <memory>
 #include <variant>
 
 namespace rigel::data
@@ -49,14 +52,18 @@ public:
     const std::vector<SDL_Event>& events) override;
 
   bool needsPerElementUpscaling() const override;
+  void printDebugText(std::ostream& stream) const override;
 
 private:
   GameSessionMode(
     const data::GameSessionId& sessionId,
     data::PlayerModel playerModel,
-    Context context);
+    Context context,
+    std::optional<game_logic::PreloadedLevel> preloadedLevel);
 
   void handleEvent(const SDL_Event& event);
+  void startPreloadingNextLevel();
+  std::optional<game_logic::PreloadedLevel> takePreloadedNextLevel();
   template <typename StageT>
   void fadeToNewStage(StageT& stage);
   void finishGameSession();
@@ -85,6 +92,8 @@ private:
   int mCurrentLevelNr;
   const data::Difficulty mDifficulty;
   Context mContext;
+  std::future<game_logic::PreloadedLevel> mPreloadedNextLevel;
+  std::unique_ptr<base::WorkerThread> mpLevelPreloader;
 };
 
 } // namespace rigel
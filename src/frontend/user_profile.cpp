@@ -19,6 +19,7 @@
 #include "assets/file_utils.hpp"
 #include "assets/user_profile_import.hpp"
 #include "base/warnings.hpp"
+#include "base/worker_thread.hpp"
 #include "frontend/json_utils.hpp"
 
 RIGEL_DISABLE_WARNINGS
@@ -30,7 +31,10 @@ RIGEL_RESTORE_WARNINGS
 
 #include <array>
 #include <fstream>
-#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
 #include <unordered_set>
 
 
@@ -758,10 +762,105 @@ UserProfile loadProfile(const std::filesystem::path& profileFile)
   return loadProfile(profileFile, profileFile);
 }
 
+
+void saveToFileAtomically(
+  const assets::ByteBuffer& buffer,
+  const std::filesystem::path& filePath)
+{
+  // We first write to a temporary file, and then replace the actual file
+  // with it. Renaming is atomic, so if the game crashes while writing, the
+  // previous version of the file is still intact. Note that we don't sync
+  // to disk before renaming, so this doesn't protect against power loss.
+  auto tempFilePath = filePath;
+  tempFilePath += ".tmp";
+
+  {
+    std::ofstream file(tempFilePath.u8string(), std::ios::binary);
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+    // Closing flushes any buffered data, which can fail (e.g. if the disk is
+    // full) even if all writes succeeded. We must not replace the previous
+    // file with a truncated one in that case.
+    file.close();
+    if (!file)
+    {
+      std::error_code ec;
+      std::filesystem::remove(tempFilePath, ec);
+      throw std::runtime_error("Failed to write " + tempFilePath.u8string());
+    }
+  }
+
+  std::filesystem::rename(tempFilePath, filePath);
+}
+
+
+void saveJsonFile(
+  const nlohmann::json& json,
+  const std::filesystem::path& filePath)
+{
+  try
+  {
+    const auto text = json.dump(4);
+    const auto buffer = assets::ByteBuffer{text.begin(), text.end()};
+    saveToFileAtomically(buffer, filePath);
+  }
+  catch (const std::exception& ex)
+  {
+    LOG_F(
+      ERROR, "Failed to write %s: %s", filePath.u8string().c_str(), ex.what());
+  }
+}
+
 } // namespace
 
 
-UserProfile::UserProfile(
+/** Writes user profile data to disk on a background thread
+ *
+ * Merging the profile with the previous profile data and writing out all the
+ * files can take a noticeable amount of time, especially on slow storage.
+ * To avoid stalling the game, this happens on a worker thread. Serializing
+ * the data into JSON is still done by the caller, so that the worker doesn't
+ * need to access the profile while it might be modified.
+ *
+ * If another save is requested while a previous one is still waiting to be
+ * written, the newer data replaces the older, so that we only write once.
+ */
+class UserProfile::AsyncWriter
+{
+public:
+  struct SaveData
+  {
+    nlohmann::json mProfile;
+    nlohmann::json mOptions;
+    nlohmann::json mModLibrary;
+  };
+
+  AsyncWriter(
+    const std::filesystem::path& profilePath,
+    assets::ByteBuffer originalJson);
+
+  void save(SaveData data);
+
+private:
+  void writePendingSave();
+  void mergeWithPreviousProfile(nlohmann::json& serializedProfile);
+
+  std::filesystem::path mProfilePath;
+
+  // Only accessed from the worker thread
+  assets::ByteBuffer mOriginalJson;
+  std::optional<nlohmann::json> moPreviousProfile;
+
+  std::mutex mMutex;
+  std::optional<SaveData> moPendingSave;
+
+  // This needs to be the last member, so that the thread finishes writing
+  // any outstanding saves before the other members are destroyed.
+  std::unique_ptr<base::WorkerThread> mpWorkerThread;
+};
+
+
+UserProfile::AsyncWriter::AsyncWriter(
   const std::filesystem::path& profilePath,
   assets::ByteBuffer originalJson)
   : mProfilePath(profilePath)
@@ -770,32 +869,75 @@ UserProfile::UserProfile(
 }
 
 
-void UserProfile::saveToDisk()
+void UserProfile::AsyncWriter::save(SaveData data)
 {
-  if (!mProfilePath)
   {
-    LOG_F(WARNING, "Not saving user profile since no file path was set");
-    return;
+    std::lock_guard lock{mMutex};
+
+    const auto writeAlreadyQueued = moPendingSave.has_value();
+    moPendingSave = std::move(data);
+
+    if (writeAlreadyQueued)
+    {
+      return;
+    }
   }
 
-  using json = nlohmann::json;
+  // Profiles are copied around a bit during loading, so we only start the
+  // thread once it's actually needed.
+  if (!mpWorkerThread)
+  {
+    mpWorkerThread = std::make_unique<base::WorkerThread>("Profile writer");
+  }
 
-  json serializedProfile;
-  serializedProfile["saveSlots"] = serialize(mSaveSlots);
-  serializedProfile["highScoreLists"] = serialize(mHighScoreLists);
+  mpWorkerThread->post([this]() { writePendingSave(); });
+}
 
-  // Starting with RigelEngine v.0.7.0, the options are stored in a separate
-  // text file. For compatibility with older versions, the options are also
-  // redundantly stored in the user profile, as before. But this is deprecated,
-  // and will be removed in a later release at some point.
-  const auto options = serialize(mOptions);
-  serializedProfile["options"] = options;
 
-  if (mGamePath)
+void UserProfile::AsyncWriter::writePendingSave()
+{
+  std::optional<SaveData> oData;
+
+  {
+    std::lock_guard lock{mMutex};
+    std::swap(oData, moPendingSave);
+  }
+
+  if (!oData)
+  {
+    return;
+  }
+
+  mergeWithPreviousProfile(oData->mProfile);
+
+  // Save user profile
+  LOG_F(INFO, "Saving user profile");
+  try
   {
-    serializedProfile["gamePath"] = mGamePath->u8string();
+    const auto buffer = nlohmann::json::to_msgpack(oData->mProfile);
+    saveToFileAtomically(buffer, mProfilePath);
   }
+  catch (const std::exception& ex)
+  {
+    LOG_F(ERROR, "Failed to store user profile: %s", ex.what());
+  }
+
+  // Save options file and mod library file
+  auto path = mProfilePath;
+
+  LOG_F(INFO, "Saving options file");
+  path.replace_filename(OPTIONS_FILENAME);
+  saveJsonFile(oData->mOptions, path);
+
+  LOG_F(INFO, "Saving mod library");
+  path.replace_filename(MOD_LIBRARY_FILENAME);
+  saveJsonFile(oData->mModLibrary, path);
+}
 
+
+void UserProfile::AsyncWriter::mergeWithPreviousProfile(
+  nlohmann::json& serializedProfile)
+{
   // This step merges the newly serialized profile into the 'old' profile
   // previously read from disk. The reason this is necessary is compatibility
   // between different versions of RigelEngine. An older version of RigelEngine
@@ -817,63 +959,73 @@ void UserProfile::saveToDisk()
   // This ensures that any settings present in the profile file are kept,
   // even if they are not part of the serializedProfile we are currently
   // writing.
-  if (mOriginalJson.size() > 0)
+  //
+  // The original data never changes, so we only parse it once, on the first
+  // save.
+  if (!mOriginalJson.empty())
   {
     try
     {
-      const auto previousProfile = json::from_msgpack(mOriginalJson);
-      serializedProfile = merge(previousProfile, serializedProfile);
+      moPreviousProfile = nlohmann::json::from_msgpack(mOriginalJson);
     }
     catch (const std::exception& ex)
     {
-      LOG_F(WARNING, "Failed to merge in previous profile data: %s", ex.what());
+      LOG_F(WARNING, "Failed to parse previous profile data: %s", ex.what());
     }
-  }
 
-  // Save user profile
-  LOG_F(INFO, "Saving user profile");
-  const auto buffer = json::to_msgpack(serializedProfile);
-  try
-  {
-    assets::saveToFile(buffer, *mProfilePath);
+    mOriginalJson = {};
   }
-  catch (const std::exception& ex)
+
+  if (moPreviousProfile)
   {
-    LOG_F(ERROR, "Failed to store user profile: %s", ex.what());
+    try
+    {
+      serializedProfile = merge(*moPreviousProfile, serializedProfile);
+    }
+    catch (const std::exception& ex)
+    {
+      LOG_F(WARNING, "Failed to merge in previous profile data: %s", ex.what());
+    }
   }
+}
 
-  // Save options file and mod library file
-  {
-    auto path = *mProfilePath;
 
-    {
-      LOG_F(INFO, "Saving options file");
+UserProfile::UserProfile(
+  const std::filesystem::path& profilePath,
+  assets::ByteBuffer originalJson)
+  : mpWriter(
+      std::make_shared<AsyncWriter>(profilePath, std::move(originalJson)))
+{
+}
 
-      path.replace_filename(OPTIONS_FILENAME);
-      auto optionsFile = std::ofstream(path.u8string());
-      LOG_IF_F(
-        ERROR,
-        !optionsFile.is_open(),
-        "Failed to open %s for writing",
-        path.u8string().c_str());
 
-      optionsFile << std::setw(4) << options;
-    }
+void UserProfile::saveToDisk()
+{
+  if (!mpWriter)
+  {
+    LOG_F(WARNING, "Not saving user profile since no file path was set");
+    return;
+  }
 
-    {
-      LOG_F(INFO, "Saving mod library");
+  AsyncWriter::SaveData data;
+  data.mProfile["saveSlots"] = serialize(mSaveSlots);
+  data.mProfile["highScoreLists"] = serialize(mHighScoreLists);
 
-      path.replace_filename(MOD_LIBRARY_FILENAME);
-      auto modLibraryFile = std::ofstream(path.u8string());
-      LOG_IF_F(
-        ERROR,
-        !modLibraryFile.is_open(),
-        "Failed to open %s for writing",
-        path.u8string().c_str());
+  // Starting with RigelEngine v.0.7.0, the options are stored in a separate
+  // text file. For compatibility with older versions, the options are also
+  // redundantly stored in the user profile, as before. But this is deprecated,
+  // and will be removed in a later release at some point.
+  data.mOptions = serialize(mOptions);
+  data.mProfile["options"] = data.mOptions;
 
-      modLibraryFile << std::setw(4) << serialize(mModLibrary);
-    }
+  if (mGamePath)
+  {
+    data.mProfile["gamePath"] = mGamePath->u8string();
   }
+
+  data.mModLibrary = serialize(mModLibrary);
+
+  mpWriter->save(std::move(data));
 }
 
 
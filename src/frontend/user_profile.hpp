@@ -23,6 +23,7 @@
 #include "data/saved_game.hpp"
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -44,7 +45,9 @@ constexpr auto USER_PROFILE_FILE_EXTENSION = ".rigel";
  * in the user profile file. Loading the profile using the aforementioned
  * function will fill these members with data accordingly. You can call
  * saveToDisk() at any time, and it will serialize the state of these members
- * into the file.
+ * into the file. The actual file writing happens in the background, so that
+ * saving doesn't cause hitches. Any pending writes are completed when the
+ * last copy of the profile is destroyed.
  *
  * When changing any of the types used for the public members, or any of the
  * types used within one of those types, you need to adapt the serialization
@@ -71,8 +74,9 @@ public:
   std::optional<std::filesystem::path> mGamePath;
 
 private:
-  std::optional<std::filesystem::path> mProfilePath;
-  assets::ByteBuffer mOriginalJson;
+  class AsyncWriter;
+
+  std::shared_ptr<AsyncWriter> mpWriter;
 };
 
 
@@ -439,6 +439,373 @@ void addItemBoxDestroyEffect(ex::Entity entity)
   entity.assign<ItemContainer>(std::move(container));
 }
 
+
+void addEffectSpriteIds(
+  base::ArrayView<effects::EffectSpec> specs,
+  std::vector<ActorID>& ids)
+{
+  for (const auto& spec : specs)
+  {
+    base::match(
+      spec.mEffect,
+      [&](const effects::EffectSprite& sprite) {
+        ids.push_back(sprite.mActorId);
+      },
+      [&](const effects::SpriteCascade& cascade) {
+        ids.push_back(cascade.mActorId);
+      },
+      [&](const effects::ScoreNumber& scoreNumber) {
+        ids.push_back(scoreNumberActor(scoreNumber.mType));
+      },
+      [](const auto&) {});
+  }
+}
+
+
+/** Returns actors which an entity configured for the given actor ID might
+ * spawn during gameplay: Container sprites, projectiles, debris etc.
+ *
+ * This needs to be kept in sync with configureEntity() and the behaviors
+ * it assigns. Sprites which any level can need, like the player's shots or
+ * generic explosions, are not listed here.
+ */
+std::vector<ActorID> actorsSpawnedBy(const ActorID actorID)
+{
+  auto ids = std::vector<ActorID>{};
+
+  auto addSpec = [&](base::ArrayView<effects::EffectSpec> specs) {
+    addEffectSpriteIds(specs, ids);
+  };
+
+  auto addItemBox = [&](const ContainerColor color) {
+    ids.push_back(actorIdForBoxColor(color));
+    addSpec(CONTAINER_BOX_KILL_EFFECT_SPEC);
+  };
+
+  auto addEnemyLaserShots = [&]() {
+    ids.insert(
+      ids.end(),
+      {ActorID::Enemy_laser_shot_LEFT,
+       ActorID::Enemy_laser_shot_RIGHT,
+       ActorID::Enemy_laser_muzzle_flash_1,
+       ActorID::Enemy_laser_muzzle_flash_2});
+  };
+
+  switch (actorID)
+  {
+    case ActorID::Blue_bonus_globe_1:
+    case ActorID::Blue_bonus_globe_2:
+    case ActorID::Blue_bonus_globe_3:
+    case ActorID::Blue_bonus_globe_4:
+      addSpec(BONUS_GLOBE_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Green_box_empty:
+    case ActorID::Red_box_empty:
+    case ActorID::Blue_box_empty:
+    case ActorID::White_box_empty:
+      addSpec(CONTAINER_BOX_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::White_box_circuit_card:
+    case ActorID::White_box_blue_key:
+    case ActorID::White_box_rapid_fire:
+    case ActorID::White_box_cloaking_device:
+      addItemBox(ContainerColor::White);
+      break;
+
+    case ActorID::Red_box_bomb:
+      addItemBox(ContainerColor::Red);
+      addSpec(NAPALM_BOMB_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Fire_bomb_fire);
+      break;
+
+    case ActorID::Red_box_cola:
+      addItemBox(ContainerColor::Red);
+      addSpec(SODA_CAN_ROCKET_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Red_box_6_pack_cola:
+      addItemBox(ContainerColor::Red);
+      addSpec(SODA_SIX_PACK_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Red_box_turkey:
+      addItemBox(ContainerColor::Red);
+      addSpec(LIVING_TURKEY_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Green_box_rocket_launcher:
+    case ActorID::Green_box_flame_thrower:
+    case ActorID::Green_box_normal_weapon:
+    case ActorID::Green_box_laser:
+      addItemBox(ContainerColor::Green);
+      break;
+
+    case ActorID::Blue_box_health_molecule:
+    case ActorID::Blue_box_N:
+    case ActorID::Blue_box_U:
+    case ActorID::Blue_box_K:
+    case ActorID::Blue_box_E:
+    case ActorID::Blue_box_M:
+    case ActorID::Blue_box_video_game_cartridge:
+    case ActorID::Blue_box_sunglasses:
+    case ActorID::Blue_box_phone:
+    case ActorID::Blue_box_boom_box:
+    case ActorID::Blue_box_disk:
+    case ActorID::Blue_box_TV:
+    case ActorID::Blue_box_camera:
+    case ActorID::Blue_box_PC:
+    case ActorID::Blue_box_CD:
+    case ActorID::Blue_box_T_shirt:
+    case ActorID::Blue_box_videocassette:
+      addItemBox(ContainerColor::Blue);
+      break;
+
+    case ActorID::Special_hint_machine:
+      ids.push_back(ActorID::Special_hint_globe_icon);
+      break;
+
+    case ActorID::Hoverbot:
+      addSpec(HOVER_BOT_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Big_green_cat_LEFT:
+    case ActorID::Big_green_cat_RIGHT:
+    case ActorID::Green_slime_blob:
+    case ActorID::Green_hanging_suction_plant:
+    case ActorID::Ugly_green_bird:
+      addSpec(BIOLOGICAL_ENEMY_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Wall_mounted_flamethrower_RIGHT:
+    case ActorID::Wall_mounted_flamethrower_LEFT:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      ids.insert(
+        ids.end(),
+        {ActorID::Flame_thrower_fire_LEFT, ActorID::Flame_thrower_fire_RIGHT});
+      break;
+
+    case ActorID::Watchbot:
+      addSpec(SIMPLE_TECH_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Rocket_launcher_turret:
+      addSpec(SIMPLE_TECH_KILL_EFFECT_SPEC);
+      ids.insert(
+        ids.end(),
+        {ActorID::Enemy_rocket_left,
+         ActorID::Enemy_rocket_up,
+         ActorID::Enemy_rocket_right});
+      break;
+
+    case ActorID::Enemy_rocket_left:
+    case ActorID::Enemy_rocket_up:
+    case ActorID::Enemy_rocket_right:
+    case ActorID::Enemy_rocket_2_up:
+    case ActorID::Enemy_rocket_2_down:
+    case ActorID::Special_hint_globe:
+    case ActorID::Snake:
+    case ActorID::Wall_walker:
+    case ActorID::Unicycle_bot:
+    case ActorID::Messenger_drone_1:
+    case ActorID::Messenger_drone_2:
+    case ActorID::Messenger_drone_3:
+    case ActorID::Messenger_drone_4:
+    case ActorID::Messenger_drone_5:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Watchbot_container_carrier:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Watchbot_container);
+      break;
+
+    case ActorID::Watchbot_container:
+      ids.insert(
+        ids.end(),
+        {ActorID::Watchbot,
+         ActorID::Watchbot_container_debris_1,
+         ActorID::Watchbot_container_debris_2});
+      break;
+
+    case ActorID::Bomb_dropping_spaceship:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Napalm_bomb);
+      break;
+
+    case ActorID::Napalm_bomb:
+      addSpec(BIG_BOMB_DETONATE_EFFECT_SPEC);
+      break;
+
+    case ActorID::Napalm_bomb_small:
+      addSpec(SMALL_BOMB_DETONATE_EFFECT_SPEC);
+      break;
+
+    case ActorID::Bouncing_spike_ball:
+      addSpec(SPIKE_BALL_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Green_slime_container:
+      addSpec(SLIME_CONTAINER_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Green_slime_blob);
+      break;
+
+    case ActorID::Camera_on_ceiling:
+    case ActorID::Camera_on_floor:
+      addSpec(CAMERA_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Eyeball_thrower_LEFT:
+      addSpec(EYE_BALL_THROWER_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Eyeball_projectile);
+      break;
+
+    case ActorID::Sentry_robot_generator:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Hoverbot);
+      break;
+
+    case ActorID::Skeleton:
+      addSpec(SKELETON_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Metal_grabber_claw:
+      addSpec(GRABBER_CLAW_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Hovering_laser_turret:
+      addSpec(TECH_KILL_EFFECT_SPEC);
+      addEnemyLaserShots();
+      break;
+
+    case ActorID::Spider:
+      addSpec(SPIDER_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Spider_shaken_off);
+      break;
+
+    case ActorID::Spiked_green_creature_LEFT:
+    case ActorID::Spiked_green_creature_RIGHT:
+      addSpec(EXTENDED_BIOLOGICAL_ENEMY_KILL_EFFECT_SPEC);
+      ids.insert(
+        ids.end(),
+        {ActorID::Spiked_green_creature_eye_FX_LEFT,
+         ActorID::Spiked_green_creature_eye_FX_RIGHT,
+         ActorID::Spiked_green_creature_stone_debris_1_LEFT,
+         ActorID::Spiked_green_creature_stone_debris_2_LEFT,
+         ActorID::Spiked_green_creature_stone_debris_3_LEFT,
+         ActorID::Spiked_green_creature_stone_debris_4_LEFT,
+         ActorID::Spiked_green_creature_stone_debris_1_RIGHT,
+         ActorID::Spiked_green_creature_stone_debris_2_RIGHT,
+         ActorID::Spiked_green_creature_stone_debris_3_RIGHT,
+         ActorID::Spiked_green_creature_stone_debris_4_RIGHT});
+      break;
+
+    case ActorID::Small_flying_ship_1:
+    case ActorID::Small_flying_ship_2:
+    case ActorID::Small_flying_ship_3:
+      addSpec(SMALL_FLYING_SHIP_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Blue_guard_RIGHT:
+    case ActorID::Blue_guard_LEFT:
+    case ActorID::Blue_guard_using_a_terminal:
+      addSpec(BLUE_GUARD_KILL_EFFECT_SPEC);
+      addEnemyLaserShots();
+      break;
+
+    case ActorID::BOSS_Episode_1:
+      ids.push_back(ActorID::Napalm_bomb_small);
+      break;
+
+    case ActorID::BOSS_Episode_3:
+      ids.insert(
+        ids.end(),
+        {ActorID::Enemy_rocket_left,
+         ActorID::Enemy_rocket_right,
+         ActorID::Enemy_rocket_2_up,
+         ActorID::Enemy_rocket_2_down});
+      break;
+
+    case ActorID::BOSS_Episode_4:
+      ids.push_back(ActorID::BOSS_Episode_4_projectile);
+      break;
+
+    case ActorID::BOSS_Episode_4_projectile:
+      addSpec(BOSS4_PROJECTILE_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Red_bird:
+      addSpec(RED_BIRD_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Aggressive_prisoner:
+      ids.push_back(ActorID::Prisoner_hand_debris);
+      break;
+
+    case ActorID::Rigelatin_soldier:
+      addSpec(RIGELATIN_KILL_EFFECT_SPEC);
+      ids.push_back(ActorID::Rigelatin_soldier_projectile);
+      break;
+
+    case ActorID::Nuclear_waste_can_empty:
+      addSpec(NUCLEAR_WASTE_BARREL_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Nuclear_waste_can_green_slime_inside:
+      ids.push_back(ActorID::Nuclear_waste_can_empty);
+      addSpec(NUCLEAR_WASTE_BARREL_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Electric_reactor:
+      addSpec(REACTOR_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Missile_broken:
+      addSpec(BROKEN_MISSILE_DETONATE_EFFECT_SPEC);
+      break;
+
+    case ActorID::Missile_intact:
+      addSpec(MISSILE_DETONATE_EFFECT_SPEC);
+      break;
+
+    case ActorID::Slime_pipe:
+      ids.push_back(ActorID::Slime_drop);
+      break;
+
+    case ActorID::Floating_exit_sign_RIGHT:
+    case ActorID::Floating_exit_sign_LEFT:
+      addSpec(EXIT_SIGN_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Floating_arrow:
+      addSpec(FLOATING_ARROW_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Radar_dish:
+      addSpec(RADAR_DISH_KILL_EFFECT_SPEC);
+      break;
+
+    case ActorID::Water_drop_spawner:
+      ids.push_back(ActorID::Water_drop);
+      break;
+
+    case ActorID::Windblown_spider_generator:
+      ids.insert(
+        ids.end(), {ActorID::Spider_debris_2, ActorID::Spider_blowing_in_wind});
+      break;
+
+    case ActorID::Explosion_FX_trigger:
+      addSpec(EXPLOSION_EFFECT_EFFECT_SPEC);
+      break;
+
+    default:
+      break;
+  }
+
+  return ids;
+}
+
 } // namespace
 
 
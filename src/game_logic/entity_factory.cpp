@@ -17,6 +17,7 @@
 #include "entity_factory.hpp"
 
 #include "base/container_utils.hpp"
+#include "base/match.hpp"
 #include "data/game_options.hpp"
 #include "data/game_traits.hpp"
 #include "data/unit_conversions.hpp"
@@ -84,6 +85,7 @@
 #include "game_logic/player/ship.hpp"
 
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 
 
@@ -453,6 +455,30 @@ void EntityFactory::createEntitiesForLevel(
 }
 
 
+std::vector<data::ActorID>
+  actorIdsForLevel(const data::map::ActorDescriptionList& actors)
+{
+  auto ids = utils::transformed(
+    actors, [](const auto& actor) { return actor.mID; });
+  auto seenIds = std::unordered_set<ActorID>{ids.begin(), ids.end()};
+
+  // Spawned actors can in turn spawn other actors, e.g. a bomber plane drops
+  // bombs which explode into fireballs. Keep going until nothing new shows up.
+  for (auto i = std::size_t{0}; i < ids.size(); ++i)
+  {
+    for (const auto spawnedId : actorsSpawnedBy(ids[i]))
+    {
+      if (seenIds.insert(spawnedId).second)
+      {
+        ids.push_back(spawnedId);
+      }
+    }
+  }
+
+  return ids;
+}
+
+
 entityx::Entity spawnOneShotSprite(
   IEntityFactory& factory,
   const ActorID id,
@@ -134,4 +134,14 @@ private:
   data::Difficulty mDifficulty;
 };
 
+
+/** Returns the IDs of all actors which can appear in the given level
+ *
+ * Besides the level's own actors, this includes actors which the entities
+ * created for them can spawn while the game is running, like an item box's
+ * container sprite, enemy projectiles, or debris.
+ */
+std::vector<data::ActorID>
+  actorIdsForLevel(const data::map::ActorDescriptionList& actors);
+
 } // namespace rigel::game_logic
@@ -18,6 +18,7 @@
 
 #include "assets/resource_loader.hpp"
 #include "base/match.hpp"
+#include "base/tracing.hpp"
 #include "data/game_options.hpp"
 #include "data/game_traits.hpp"
 #include "data/map.hpp"
@@ -201,17 +202,13 @@ std::string vec2String(const base::Vec2T<ValueT>& vec, const int width)
 
 
 std::vector<engine::WaterEffectArea> collectWaterEffectAreas(
-  entityx::EntityManager& es,
-  const base::Vec2& cameraPosition,
-  const base::Size& viewportSize)
+  entityx::EntityManager& es)
 {
   using engine::components::BoundingBox;
   using game_logic::components::ActorTag;
 
   std::vector<engine::WaterEffectArea> result;
 
-  const auto screenBox = BoundingBox{cameraPosition, viewportSize};
-
   es.each<ActorTag, WorldPosition, BoundingBox>([&](
                                                   entityx::Entity,
                                                   const ActorTag& tag,
@@ -224,17 +221,12 @@ std::vector<engine::WaterEffectArea> collectWaterEffectAreas(
     if (isWaterArea)
     {
       const auto worldSpaceBbox = engine::toWorldSpace(bbox, position);
+      const auto hasAnimatedSurface = tag.mType == T::AnimatedWaterArea;
 
-      if (screenBox.intersects(worldSpaceBbox))
-      {
-        const auto topLeftPx =
-          data::tilesToPixels(worldSpaceBbox.topLeft - cameraPosition);
-        const auto sizePx = data::tilesToPixels(worldSpaceBbox.size);
-        const auto hasAnimatedSurface = tag.mType == T::AnimatedWaterArea;
-
-        result.push_back(
-          engine::WaterEffectArea{{topLeftPx, sizePx}, hasAnimatedSurface});
-      }
+      result.push_back(engine::WaterEffectArea{
+        {data::tilesToPixels(worldSpaceBbox.topLeft),
+         data::tilesToPixels(worldSpaceBbox.size)},
+        hasAnimatedSurface});
     }
   });
 
@@ -261,7 +253,8 @@ GameWorld::GameWorld(
   GameMode::Context context,
   std::optional<base::Vec2> playerPositionOverride,
   bool showWelcomeMessage,
-  const PlayerInput& initialInput)
+  const PlayerInput& initialInput,
+  std::optional<PreloadedLevel> preloadedLevel)
   : mpRenderer(context.mpRenderer)
   , mpServiceProvider(context.mpServiceProvider)
   , mUiSpriteSheet(
@@ -298,10 +291,11 @@ GameWorld::GameWorld(
   , mWidescreenModeWasOn(widescreenModeOn())
   , mPerElementUpscalingWasEnabled(mpOptions->mPerElementUpscalingEnabled)
   , mMotionSmoothingWasEnabled(mpOptions->mMotionSmoothing)
+  , mMapTextures(mpRenderer)
 {
   LOG_SCOPE_FUNCTION(INFO);
 
-  loadLevel(initialInput);
+  loadLevel(initialInput, std::move(preloadedLevel));
 
   if (playerPositionOverride)
   {
@@ -530,9 +524,11 @@ void GameWorld::receive(const rigel::events::CloakExpired&)
 }
 
 
-void GameWorld::loadLevel(const PlayerInput& initialInput)
+void GameWorld::loadLevel(
+  const PlayerInput& initialInput,
+  std::optional<PreloadedLevel> preloadedLevel)
 {
-  createNewState();
+  createNewState(std::move(preloadedLevel));
 
   mpState->mCamera.centerViewOnPlayer();
   updateGameLogic(initialInput);
@@ -549,23 +545,46 @@ void GameWorld::loadLevel(const PlayerInput& initialInput)
 }
 
 
-void GameWorld::createNewState()
+void GameWorld::createNewState(std::optional<PreloadedLevel> preloadedLevel)
 {
+  mpServiceProvider->markCurrentFrameAsLoading();
+
   if (mpState)
   {
     unsubscribe(mpState->mEventManager);
   }
 
-  mpState = std::make_unique<WorldState>(
-    mpServiceProvider,
-    mpRenderer,
-    mpResources,
-    mpPlayerModel,
-    mpOptions,
-    mpSpriteFactory,
-    mSessionId);
+  if (preloadedLevel)
+  {
+    mpState = std::make_unique<WorldState>(
+      mpServiceProvider,
+      mpRenderer,
+      mpResources,
+      mpPlayerModel,
+      mpOptions,
+      mpSpriteFactory,
+      &mMapTextures,
+      mSessionId,
+      std::move(*preloadedLevel));
+  }
+  else
+  {
+    mpState = std::make_unique<WorldState>(
+      mpServiceProvider,
+      mpRenderer,
+      mpResources,
+      mpPlayerModel,
+      mpOptions,
+      mpSpriteFactory,
+      &mMapTextures,
+      mSessionId);
+  }
 
   subscribe(mpState->mEventManager);
+
+  // Water areas are placed at level load and never move or disappear
+  mSpecialEffects.setWaterEffectAreas(
+    collectWaterEffectAreas(mpState->mEntities));
 }
 
 
@@ -665,7 +684,7 @@ void GameWorld::updateGameLogic(const PlayerInput& input)
   mpState->mPreviousCameraPosition = mpState->mCamera.position();
   mpState->mCamera.update(input, viewportSize);
 
-  engine::markActiveEntities(
+  mpState->mEntityActivationSystem.update(
     mpState->mEntities, mpState->mCamera.position(), viewportSize);
   mpState->mBehaviorControllerSystem.update(
     mpState->mEntities,
@@ -696,10 +715,12 @@ void GameWorld::updateGameLogic(const PlayerInput& input)
 
   mpState->mParticles.update();
 
+  mpState->mSpriteRenderingSystem.invalidate();
   if (!mpOptions->mMotionSmoothing)
   {
     mpState->mSpriteRenderingSystem.update(
-      mpState->mEntities, viewportSize, mpState->mCamera.position(), 1.0f);
+      mpState->mEntities, viewportSize, mpState->mCamera.position());
+    mpState->mSpriteRenderingSystem.interpolate(1.0f);
   }
 
   mpState->mIsOddFrame = !mpState->mIsOddFrame;
@@ -708,6 +729,8 @@ void GameWorld::updateGameLogic(const PlayerInput& input)
 
 void GameWorld::render(const float interpolationFactor)
 {
+  RIGEL_TRACE_SCOPE("GameWorld::render");
+
   if (
     widescreenModeOn() != mWidescreenModeWasOn ||
     mpOptions->mPerElementUpscalingEnabled != mPerElementUpscalingWasEnabled ||
@@ -731,7 +754,10 @@ void GameWorld::render(const float interpolationFactor)
 
   if (mpOptions->mMotionSmoothing != mMotionSmoothingWasEnabled)
   {
+    // Previous positions have changed, so the sprite motion data collected
+    // by the sprite rendering system is outdated
     updateMotionSmoothingStates();
+    mpState->mSpriteRenderingSystem.invalidate();
     mMotionSmoothingWasEnabled = mpOptions->mMotionSmoothing;
   }
 
@@ -840,7 +866,8 @@ void GameWorld::render(const float interpolationFactor)
     if (!mWidescreenModeWasOn && !mpOptions->mMotionSmoothing)
     {
       mpState->mSpriteRenderingSystem.update(
-        mpState->mEntities, viewportSize, mpState->mCamera.position(), 1.0f);
+        mpState->mEntities, viewportSize, mpState->mCamera.position());
+      mpState->mSpriteRenderingSystem.interpolate(1.0f);
     }
 
     if (mpOptions->mPerElementUpscalingEnabled)
@@ -981,6 +1008,11 @@ void GameWorld::drawMapAndSprites(
 
   auto& state = *mpState;
 
+  const auto renderStartPositionPx =
+    data::tilesToPixels(params.mRenderStartPosition);
+  const auto waterEffectVisible = mSpecialEffects.selectVisibleWaterAreas(
+    {renderStartPositionPx, data::tilesToPixels(params.mViewportSize)});
+
   auto renderBackdrop = [&]() {
     if (state.mBackdropFlashColor)
     {
@@ -1012,7 +1044,10 @@ void GameWorld::drawMapAndSprites(
       params.mRenderStartPosition, params.mViewportSize);
     state.mDynamicGeometrySystem.renderDynamicBackgroundSections(
       params.mRenderStartPosition, params.mViewportSize, interpolationFactor);
-    state.mSpriteRenderingSystem.renderRegularSprites(mSpecialEffects);
+    // With the water effect visible, cloaked sprites need to be part of the
+    // background buffer so that they are tinted when inside water
+    state.mSpriteRenderingSystem.renderRegularSprites(
+      mSpecialEffects, waterEffectVisible);
   };
 
   auto renderForegroundLayers = [&]() {
@@ -1027,19 +1062,18 @@ void GameWorld::drawMapAndSprites(
 
   auto outerStateSave = renderer::saveState(mpRenderer);
 
+  // Sprites are only collected again after a game logic update, or when
+  // the viewport has changed. In between, we only need to update their
+  // positions.
   if (mpOptions->mMotionSmoothing)
   {
     mpState->mSpriteRenderingSystem.update(
-      mpState->mEntities,
-      params.mViewportSize,
-      params.mRenderStartPosition,
-      interpolationFactor);
+      mpState->mEntities, params.mViewportSize, params.mRenderStartPosition);
+    mpState->mSpriteRenderingSystem.interpolate(interpolationFactor);
   }
 
-  const auto waterEffectAreas = collectWaterEffectAreas(
-    state.mEntities, params.mRenderStartPosition, params.mViewportSize);
   if (
-    waterEffectAreas.empty() &&
+    !waterEffectVisible &&
     !mpState->mSpriteRenderingSystem.cloakEffectSpritesVisible())
   {
     renderBackdrop();
@@ -1062,7 +1096,22 @@ void GameWorld::drawMapAndSprites(
 
     renderer::setLocalTranslation(mpRenderer, params.mCameraOffset);
 
-    mSpecialEffects.drawWaterEffect(waterEffectAreas, state.mWaterAnimStep);
+    {
+      auto saved = renderer::saveState(mpRenderer);
+      renderer::setLocalTranslation(
+        mpRenderer, base::Vec2{} - renderStartPositionPx);
+      mSpecialEffects.drawWaterEffect(state.mWaterAnimStep);
+    }
+
+    // Without water, cloaked sprites are drawn once the background buffer is
+    // complete, since they sample it. That way, we can draw all of them in
+    // one go without any intermediate buffers.
+    if (!waterEffectVisible)
+    {
+      state.mSpriteRenderingSystem.renderCloakedRegularSprites(
+        mSpecialEffects);
+    }
+
     renderForegroundLayers();
   }
 }
@@ -1153,6 +1202,7 @@ void GameWorld::quickSave()
   }
 
   LOG_F(INFO, "Creating quick save");
+  mpServiceProvider->markCurrentFrameAsLoading();
 
   auto pStateCopy = std::make_unique<WorldState>(
     mpServiceProvider,
@@ -1161,6 +1211,7 @@ void GameWorld::quickSave()
     mpPlayerModel,
     mpOptions,
     mpSpriteFactory,
+    &mMapTextures,
     mSessionId);
   pStateCopy->synchronizeTo(
     *mpState, mpServiceProvider, mpPlayerModel, mSessionId);
@@ -1182,6 +1233,7 @@ void GameWorld::quickLoad()
   }
 
   LOG_F(INFO, "Loading quick save");
+  mpServiceProvider->markCurrentFrameAsLoading();
 
   *mpPlayerModel = mpQuickSave->mPlayerModel;
   mpState->synchronizeTo(
@@ -1189,13 +1241,15 @@ void GameWorld::quickLoad()
   mpState->mPreviousCameraPosition = mpState->mCamera.position();
   mMessageDisplay.setMessage("Quick save restored.", ui::MessagePriority::Menu);
 
+  mpState->mSpriteRenderingSystem.invalidate();
   if (!mpOptions->mMotionSmoothing)
   {
     const auto& viewportSize = widescreenModeOn()
       ? viewportSizeWideScreen(mpRenderer, *mpOptions)
       : data::GameTraits::mapViewportSize;
     mpState->mSpriteRenderingSystem.update(
-      mpState->mEntities, viewportSize, mpState->mCamera.position(), 1.0f);
+      mpState->mEntities, viewportSize, mpState->mCamera.position());
+    mpState->mSpriteRenderingSystem.interpolate(1.0f);
   }
 
   LOG_F(INFO, "Quick save loaded");
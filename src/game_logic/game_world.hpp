@@ -24,11 +24,13 @@
 #include "data/player_model.hpp"
 #include "data/tutorial_messages.hpp"
 #include "engine/graphical_effects.hpp"
+#include "engine/map_renderer.hpp"
 #include "engine/sprite_factory.hpp"
 #include "frontend/game_mode.hpp"
 #include "game_logic/damage_components.hpp"
 #include "game_logic/global_dependencies.hpp"
 #include "game_logic/input.hpp"
+#include "game_logic/preloaded_level.hpp"
 #include "ui/hud_renderer.hpp"
 #include "ui/ingame_message_display.hpp"
 #include "ui/menu_element_renderer.hpp"
@@ -80,7 +82,8 @@ public:
     GameMode::Context context,
     std::optional<base::Vec2> playerPositionOverride = std::nullopt,
     bool showWelcomeMessage = false,
-    const PlayerInput& initialInput = PlayerInput{});
+    const PlayerInput& initialInput = PlayerInput{},
+    std::optional<PreloadedLevel> preloadedLevel = std::nullopt);
   ~GameWorld(); // NOLINT
 
   bool levelFinished() const;
@@ -126,8 +129,10 @@ private:
     base::Size mViewportSize;
   };
 
-  void loadLevel(const PlayerInput& initialInput);
-  void createNewState();
+  void loadLevel(
+    const PlayerInput& initialInput,
+    std::optional<PreloadedLevel> preloadedLevel = std::nullopt);
+  void createNewState(std::optional<PreloadedLevel> preloadedLevel);
   void subscribe(entityx::EventManager& eventManager);
   void unsubscribe(entityx::EventManager& eventManager);
 
@@ -180,6 +185,7 @@ private:
   bool mWidescreenModeWasOn;
   bool mPerElementUpscalingWasEnabled;
   bool mMotionSmoothingWasEnabled;
+  engine::MapTextureCache mMapTextures;
 
   std::unique_ptr<WorldState> mpState;
   std::unique_ptr<QuickSaveData> mpQuickSave;
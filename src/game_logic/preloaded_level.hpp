@@ -0,0 +1,51 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "data/game_session_data.hpp"
+#include "data/map.hpp"
+#include "game_logic/dynamic_geometry_system.hpp"
+
+
+namespace rigel::assets
+{
+class ResourceLoader;
+}
+
+
+namespace rigel::game_logic
+{
+
+/** Level data that can be prepared ahead of time, without touching the GPU
+ *
+ * Loading and decoding a level's files and splitting its map into static
+ * and dynamic parts only needs the resource loader, so it can run on a
+ * background thread. Creating a WorldState from the result then only needs
+ * to do texture uploads and entity creation.
+ */
+struct PreloadedLevel
+{
+  data::map::LevelData mLevel;
+  DynamicMapSectionData mDynamicMapSections;
+};
+
+
+PreloadedLevel preloadLevel(
+  const assets::ResourceLoader& resources,
+  const data::GameSessionId& sessionId);
+
+} // namespace rigel::game_logic
@@ -140,6 +140,20 @@ BonusRelatedItemCounts countBonusRelatedItems(entityx::EntityManager& es)
 }
 
 
+PreloadedLevel preloadLevel(
+  const assets::ResourceLoader& resources,
+  const data::GameSessionId& sessionId)
+{
+  auto level = assets::loadLevel(
+    levelFileName(sessionId.mEpisode, sessionId.mLevel),
+    resources,
+    sessionId.mDifficulty);
+  auto dynamicMapSections =
+    determineDynamicMapSections(level.mMap, level.mActors);
+  return PreloadedLevel{std::move(level), std::move(dynamicMapSections)};
+}
+
+
 WorldState::WorldState(
   IGameServiceProvider* pServiceProvider,
   renderer::Renderer* pRenderer,
@@ -147,6 +161,7 @@ WorldState::WorldState(
   data::PlayerModel* pPlayerModel,
   const data::GameOptions* pOptions,
   engine::SpriteFactory* pSpriteFactory,
+  engine::MapTextureCache* pMapTextureCache,
   const data::GameSessionId sessionId)
   : WorldState(
       pServiceProvider,
@@ -155,6 +170,7 @@ WorldState::WorldState(
       pPlayerModel,
       pOptions,
       pSpriteFactory,
+      pMapTextureCache,
       sessionId,
       assets::loadLevel(
         levelFileName(sessionId.mEpisode, sessionId.mLevel),
@@ -171,6 +187,7 @@ WorldState::WorldState(
   data::PlayerModel* pPlayerModel,
   const data::GameOptions* pOptions,
   engine::SpriteFactory* pSpriteFactory,
+  engine::MapTextureCache* pMapTextureCache,
   const data::GameSessionId sessionId,
   data::map::LevelData&& loadedLevel)
   : WorldState(
@@ -180,6 +197,7 @@ WorldState::WorldState(
       pPlayerModel,
       pOptions,
       pSpriteFactory,
+      pMapTextureCache,
       sessionId,
       determineDynamicMapSections(loadedLevel.mMap, loadedLevel.mActors),
       std::move(loadedLevel))
@@ -194,6 +212,32 @@ WorldState::WorldState(
   data::PlayerModel* pPlayerModel,
   const data::GameOptions* pOptions,
   engine::SpriteFactory* pSpriteFactory,
+  engine::MapTextureCache* pMapTextureCache,
+  const data::GameSessionId sessionId,
+  PreloadedLevel&& preloadedLevel)
+  : WorldState(
+      pServiceProvider,
+      pRenderer,
+      pResources,
+      pPlayerModel,
+      pOptions,
+      pSpriteFactory,
+      pMapTextureCache,
+      sessionId,
+      std::move(preloadedLevel.mDynamicMapSections),
+      std::move(preloadedLevel.mLevel))
+{
+}
+
+
+WorldState::WorldState(
+  IGameServiceProvider* pServiceProvider,
+  renderer::Renderer* pRenderer,
+  const assets::ResourceLoader* pResources,
+  data::PlayerModel* pPlayerModel,
+  const data::GameOptions* pOptions,
+  engine::SpriteFactory* pSpriteFactory,
+  engine::MapTextureCache* pMapTextureCache,
   const data::GameSessionId sessionId,
   DynamicMapSectionData&& dynamicMapSections,
   data::map::LevelData&& loadedLevel)
@@ -208,6 +252,7 @@ WorldState::WorldState(
       sessionId.mDifficulty)
   , mRadarDishCounter(mEntities, mEventManager)
   , mCollisionChecker(&mMap, mEntities, mEventManager)
+  , mEntityActivationSystem(mEntities, mEventManager)
   , mpOptions(pOptions)
   , mPlayer(
       [&]() {
@@ -240,7 +285,11 @@ WorldState::WorldState(
         std::move(loadedLevel.mTileSetImage),
         std::move(loadedLevel.mBackdropImage),
         std::move(loadedLevel.mSecondaryBackdropImage),
-        loadedLevel.mBackdropScrollMode})
+        loadedLevel.mBackdropScrollMode,
+        std::move(loadedLevel.mTileSetName),
+        std::move(loadedLevel.mBackdropName),
+        std::move(loadedLevel.mSecondaryBackdropName)},
+      pMapTextureCache)
   , mPhysicsSystem(&mCollisionChecker, &mMap, &mEventManager)
   , mDebuggingSystem(pRenderer, &mMap)
   , mPlayerInteractionSystem(
@@ -290,6 +339,7 @@ WorldState::WorldState(
   , mLevelMusicFile(loadedLevel.mMusicFile)
   , mBackdropSwitchCondition(loadedLevel.mBackdropSwitchCondition)
 {
+  pSpriteFactory->prefetch(actorIdsForLevel(loadedLevel.mActors));
   mEntityFactory.createEntitiesForLevel(loadedLevel.mActors);
   mDynamicGeometrySystem.initializeDynamicGeometryEntities(
     dynamicMapSections.mFallingSections);
@@ -44,6 +44,7 @@
 #include "game_logic/player/damage_system.hpp"
 #include "game_logic/player/interaction_system.hpp"
 #include "game_logic/player/projectile_system.hpp"
+#include "game_logic/preloaded_level.hpp"
 
 RIGEL_DISABLE_WARNINGS
 #include <entityx/entityx.h>
@@ -118,6 +119,7 @@ struct WorldState
     data::PlayerModel* pPlayerModel,
     const data::GameOptions* pOptions,
     engine::SpriteFactory* pSpriteFactory,
+    engine::MapTextureCache* pMapTextureCache,
     data::GameSessionId sessionId);
   WorldState(
     IGameServiceProvider* pServiceProvider,
@@ -126,6 +128,7 @@ struct WorldState
     data::PlayerModel* pPlayerModel,
     const data::GameOptions* pOptions,
     engine::SpriteFactory* pSpriteFactory,
+    engine::MapTextureCache* pMapTextureCache,
     data::GameSessionId sessionId,
     data::map::LevelData&& loadedLevel);
   WorldState(
@@ -135,6 +138,17 @@ struct WorldState
     data::PlayerModel* pPlayerModel,
     const data::GameOptions* pOptions,
     engine::SpriteFactory* pSpriteFactory,
+    engine::MapTextureCache* pMapTextureCache,
+    data::GameSessionId sessionId,
+    PreloadedLevel&& preloadedLevel);
+  WorldState(
+    IGameServiceProvider* pServiceProvider,
+    renderer::Renderer* pRenderer,
+    const assets::ResourceLoader* pResources,
+    data::PlayerModel* pPlayerModel,
+    const data::GameOptions* pOptions,
+    engine::SpriteFactory* pSpriteFactory,
+    engine::MapTextureCache* pMapTextureCache,
     data::GameSessionId sessionId,
     DynamicMapSectionData&& dynamicMapSections,
     data::map::LevelData&& loadedLevel);
@@ -153,6 +167,7 @@ struct WorldState
   EntityFactory mEntityFactory;
   RadarDishCounter mRadarDishCounter;
   engine::CollisionChecker mCollisionChecker;
+  engine::EntityActivationSystem mEntityActivationSystem;
   const data::GameOptions* mpOptions;
 
   Player mPlayer;
@@ -19,6 +19,7 @@
 #include "version_info.hpp"
 
 #include "base/defer.hpp"
+#include "base/tracing.hpp"
 #include "frontend/game.hpp"
 #include "renderer/opengl.hpp"
 #include "sdl_utils/error.hpp"
@@ -37,6 +38,8 @@ RIGEL_RESTORE_WARNINGS
 
 #include <filesystem>
 #include <fstream>
+#include <optional>
+#include <string>
 
 
 namespace rigel
@@ -255,9 +258,23 @@ void initAndRunGame(
     optionsForRestartedGame.mDebugModeEnabled =
       commandLineOptions.mDebugModeEnabled;
     optionsForRestartedGame.mDisableAudio = commandLineOptions.mDisableAudio;
+    optionsForRestartedGame.mFrameSpikeThresholdMs =
+      commandLineOptions.mFrameSpikeThresholdMs;
 
+    auto numRestarts = 0;
     while (result == Game::StopReason::RestartNeeded)
     {
+      // Keep capturing frames after restarting, but into a sub directory,
+      // so that the frames recorded so far aren't overwritten.
+      if (!commandLineOptions.mFrameCapturePath.empty())
+      {
+        ++numRestarts;
+        optionsForRestartedGame.mFrameCapturePath =
+          (std::filesystem::u8path(commandLineOptions.mFrameCapturePath) /
+           ("restart_" + std::to_string(numRestarts)))
+            .u8string();
+      }
+
       result = run(optionsForRestartedGame, false);
     }
   }
@@ -295,6 +312,27 @@ void logVersionAndSystemInfo()
     pSdlMixerVersion->patch);
 }
 
+
+std::optional<base::ScopeGuard> startTracingIfEnabled()
+{
+#if defined(RIGEL_ENABLE_TRACING) && RIGEL_ENABLE_TRACING
+  constexpr auto TRACE_FILE_NAME = "RigelEngine_trace.json";
+
+  const auto maybePrefsDir = createOrGetPreferencesPath();
+  const auto tracePath = maybePrefsDir
+    ? (*maybePrefsDir / TRACE_FILE_NAME).u8string()
+    : std::string{TRACE_FILE_NAME};
+
+  LOG_F(INFO, "Tracing enabled, writing trace to %s", tracePath.c_str());
+
+  RIGEL_TRACE_THREAD_NAME("Main thread");
+  base::tracing::beginSession(tracePath);
+  return base::defer([]() { base::tracing::endSession(); });
+#else
+  return std::nullopt;
+#endif
+}
+
 } // namespace
 
 
@@ -351,6 +389,8 @@ int gameMain(const CommandLineOptions& options)
     pWindow.get(), pGlContext, createOrGetPreferencesPath());
   auto imGuiGuard = defer([]() { ui::imgui_integration::shutdown(); });
 
+  auto tracingGuard = startTracingIfEnabled();
+
   try
   {
     initAndRunGame(pWindow.get(), userProfile, options);
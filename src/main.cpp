@@ -179,6 +179,13 @@ std::variant<CommandLineOptions, int> parseArgs(int argc, char** argv)
       .help("Disable all audio output")
     | lyra::opt(config.mPlayDemo)["--play-demo"]
       .help("Play pre-recorded demo")
+    | lyra::opt(config.mPreloadAllSprites)["--preload-sprites"]
+      .help("Load all sprites at startup instead of on demand")
+    | lyra::opt(config.mFrameCapturePath, "directory")["--capture-frames"]
+      .help("Record all presented frames into the given directory")
+    | lyra::opt(config.mFrameSpikeThresholdMs, "ms")["--frame-spike-threshold"]
+      .help(
+        "Log frame timings when a frame takes longer than this (0 = never)")
     | lyra::group([&](const lyra::group&){})
       .add_argument(lyra::opt([&](const std::string& levelSpec){
           config.mLevelToJumpTo = data::GameSessionId{
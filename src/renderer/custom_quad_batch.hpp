@@ -64,6 +64,13 @@ public:
     mVertices.insert(mVertices.end(), std::begin(vertices), std::end(vertices));
   }
 
+  void addQuad(const QuadVertices& vertices)
+  {
+    mVertices.insert(mVertices.end(), std::begin(vertices), std::end(vertices));
+  }
+
+  bool empty() const { return mVertices.empty(); }
+
   CustomQuadBatchData data() const { return {mTextures, mVertices, mpShader}; }
 
 private:
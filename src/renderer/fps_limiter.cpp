@@ -16,36 +16,145 @@
 
 #include "fps_limiter.hpp"
 
+#include "base/tracing.hpp"
+
 #include <SDL_timer.h>
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 
 namespace rigel::renderer
 {
 
+namespace
+{
+
+using namespace std::chrono_literals;
+
+// Sleeping has millisecond granularity, so we always leave at least that
+// much time for the spin-wait.
+constexpr auto MIN_SPIN_TIME = base::Clock::duration{1ms};
+
+// Swapping buffers normally returns almost immediately when v-sync is off.
+// If it takes longer than this, the driver is making us wait.
+constexpr auto SWAP_BLOCKING_THRESHOLD = base::Clock::duration{1ms};
+
+} // namespace
+
+
 FpsLimiter::FpsLimiter(const int targetFps)
-  : mLastTime(base::Clock::now())
-  , mTargetFrameTime(1.0 / targetFps)
+  : mNextFrameTime(base::Clock::now())
+  , mLastFrameStartTime(mNextFrameTime)
+  , mTargetFrameTime(
+      std::chrono::duration_cast<base::Clock::duration>(
+        std::chrono::duration<double>(1.0 / targetFps)))
+  , mSleepOvershoot(MIN_SPIN_TIME)
+  , mFrameTimes()
 {
 }
 
 
-void FpsLimiter::updateAndWait()
+void FpsLimiter::updateAndWait(const base::Clock::duration swapDuration)
 {
+  RIGEL_TRACE_SCOPE("FpsLimiter::updateAndWait");
+
   using namespace std::chrono;
 
+  mNextFrameTime += mTargetFrameTime;
+
+  // If the swap blocked, we presented too early for the display. Shifting
+  // the schedule by half the blocked time converges on the display's timing
+  // without overshooting.
+  if (swapDuration > SWAP_BLOCKING_THRESHOLD)
+  {
+    mNextFrameTime += swapDuration / 2;
+  }
+
+  // If we've fallen behind by more than a frame, e.g. due to loading, we
+  // don't want to catch up by running several frames without waiting.
   const auto now = base::Clock::now();
-  const auto delta = duration<double>(now - mLastTime).count();
-  mLastTime = now;
+  if (now - mNextFrameTime > mTargetFrameTime)
+  {
+    mNextFrameTime = now;
+  }
 
-  mError += mTargetFrameTime - delta;
+  waitUntil(mNextFrameTime);
 
-  const auto timeToWaitFor = mTargetFrameTime + mError;
-  if (timeToWaitFor > 0.0)
+  const auto frameStartTime = base::Clock::now();
+  recordFrameTime(
+    duration<double>(frameStartTime - mLastFrameStartTime).count());
+  mLastFrameStartTime = frameStartTime;
+}
+
+
+FrameTimeStats FpsLimiter::frameTimeStats() const
+{
+  if (mNumFrameTimes == 0)
+  {
+    return {};
+  }
+
+  const auto iBegin = mFrameTimes.begin();
+  const auto iEnd = std::next(iBegin, mNumFrameTimes);
+
+  auto sum = 0.0;
+  auto sumOfSquares = 0.0;
+  auto max = 0.0;
+  std::for_each(iBegin, iEnd, [&](const double frameTime) {
+    sum += frameTime;
+    sumOfSquares += frameTime * frameTime;
+    max = std::max(max, frameTime);
+  });
+
+  const auto mean = sum / mNumFrameTimes;
+  const auto variance =
+    std::max(sumOfSquares / mNumFrameTimes - mean * mean, 0.0);
+
+  return {mean, std::sqrt(variance), max};
+}
+
+
+void FpsLimiter::waitUntil(const base::Clock::time_point time)
+{
+  using namespace std::chrono;
+
+  const auto sleepStartTime = base::Clock::now();
+  const auto timeToSleep =
+    duration_cast<milliseconds>(time - sleepStartTime - mSleepOvershoot);
+
+  if (timeToSleep.count() > 0)
   {
     // We use SDL_Delay instead of std::this_thread::sleep_for, because the
     // former is more accurate on some platforms.
-    SDL_Delay(static_cast<Uint32>(timeToWaitFor * 1000.0));
+    SDL_Delay(static_cast<Uint32>(timeToSleep.count()));
+
+    // Sleeping too long makes us miss the deadline, so we immediately adopt
+    // a larger overshoot, but only slowly decrease it again.
+    const auto overshoot = std::max(
+      duration_cast<base::Clock::duration>(
+        base::Clock::now() - sleepStartTime - timeToSleep),
+      MIN_SPIN_TIME);
+    mSleepOvershoot = overshoot > mSleepOvershoot
+      ? overshoot
+      : mSleepOvershoot - (mSleepOvershoot - overshoot) / 16;
+  }
+
+  // Spin for the remaining time. Yielding gives other threads a chance to
+  // run, so that we don't needlessly occupy a CPU core.
+  while (base::Clock::now() < time)
+  {
+    std::this_thread::yield();
   }
 }
 
+
+void FpsLimiter::recordFrameTime(const double frameTime)
+{
+  mFrameTimes[mNextFrameTimeIndex] = frameTime;
+  mNextFrameTimeIndex = (mNextFrameTimeIndex + 1) % NUM_FRAME_TIME_SAMPLES;
+  mNumFrameTimes = std::min(mNumFrameTimes + 1, NUM_FRAME_TIME_SAMPLES);
+}
+
 } // namespace rigel::renderer
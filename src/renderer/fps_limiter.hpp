@@ -18,21 +18,61 @@
 
 #include "base/clock.hpp"
 
+#include <array>
+
 
 namespace rigel::renderer
 {
 
+/** Statistics about recent frame times, in seconds */
+struct FrameTimeStats
+{
+  double mMean = 0.0;
+  double mStandardDeviation = 0.0;
+  double mMax = 0.0;
+};
+
+
+/** Limits the frame rate to a given target
+ *
+ * Frames are scheduled on a fixed grid based on the target frame time.
+ * Waiting for the next frame is done by sleeping for most of the remaining
+ * time, followed by a short spin-wait. Sleeping alone is too imprecise for
+ * high frame rates, since it only has millisecond granularity and often
+ * takes longer than requested. How much longer is measured continuously, to
+ * keep the spin-wait as short as possible.
+ */
 class FpsLimiter
 {
 public:
   explicit FpsLimiter(int targetFps);
 
-  void updateAndWait();
+  /** Wait until it's time to start the next frame
+   *
+   * Should be called right after swapping buffers. If swapping blocked for
+   * a while, e.g. because the driver or compositor waits for the display's
+   * vertical blank, the schedule is shifted towards the end of the swap.
+   * That way, subsequent frames are presented with less waiting.
+   */
+  void updateAndWait(base::Clock::duration swapDuration = {});
+
+  /** Returns statistics for the most recent frames */
+  FrameTimeStats frameTimeStats() const;
 
 private:
-  base::Clock::time_point mLastTime = {};
-  double mTargetFrameTime;
-  double mError = 0.0;
+  void waitUntil(base::Clock::time_point time);
+  void recordFrameTime(double frameTime);
+
+  static constexpr auto NUM_FRAME_TIME_SAMPLES = 120;
+
+  base::Clock::time_point mNextFrameTime;
+  base::Clock::time_point mLastFrameStartTime;
+  base::Clock::duration mTargetFrameTime;
+  base::Clock::duration mSleepOvershoot;
+
+  std::array<double, NUM_FRAME_TIME_SAMPLES> mFrameTimes;
+  int mNumFrameTimes = 0;
+  int mNextFrameTimeIndex = 0;
 };
 
 } // namespace rigel::renderer
@@ -32,6 +32,7 @@ RIGEL_RESTORE_WARNINGS
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <iterator>
 
 
@@ -53,6 +54,11 @@ constexpr std::array<GLenum, MAX_MULTI_TEXTURES> TEXTURE_UNIT_IDS{
   GL_TEXTURE6,
   GL_TEXTURE7};
 
+// Number of frames to wait before mapping a pixel buffer object used for
+// asynchronous framebuffer read back. By then, the GPU has almost certainly
+// finished the transfer, so mapping doesn't stall.
+constexpr auto READBACK_DELAY_FRAMES = 2;
+
 constexpr auto MAX_QUADS_PER_BATCH = 1280u;
 constexpr auto MAX_BATCH_SIZE = MAX_QUADS_PER_BATCH * std::size(QUAD_INDICES);
 
@@ -210,6 +216,23 @@ GLuint createGlTexture(
   return handle;
 }
 
+
+/** Returns a copy of the image, extended with transparent pixels on the
+ * right and bottom so that both dimensions are a multiple of the given value
+ */
+data::Image
+  paddedToMultipleOf(const data::Image& image, const std::size_t multiple)
+{
+  auto paddedSize = [multiple](const std::size_t size) {
+    return (size + multiple - 1) / multiple * multiple;
+  };
+
+  auto padded =
+    data::Image{paddedSize(image.width()), paddedSize(image.height())};
+  padded.insertImage(0, 0, image);
+  return padded;
+}
+
 } // namespace
 
 
@@ -277,6 +300,7 @@ struct Renderer::Impl
   // warm - needed for committing state changes
   State mLastCommittedState;
   std::unordered_map<TextureId, RenderTarget> mRenderTargetDict;
+  std::unordered_map<TextureId, int> mMipLevelsByTexture;
   Shader mTexturedQuadShader;
   Shader mSimpleTexturedQuadShader;
   Shader mSolidColorShader;
@@ -288,9 +312,21 @@ struct Renderer::Impl
   // cold
   int mNumTextures = 0;
   int mNumVbos = 0;
+  int mMaxTextureSize = 0;
   DummyVao mDummyVao;
   GLuint mStreamVbo = 0;
 
+  struct PendingReadback
+  {
+    GLuint mPbo;
+    base::Size mSize;
+    int mFramesUntilReady;
+    std::function<void(data::Image)> mCallback;
+  };
+
+  std::vector<PendingReadback> mPendingReadbacks;
+  std::vector<GLuint> mFreeReadbackPbos;
+
 
   explicit Impl(SDL_Window* pWindow)
     : mTexturedQuadShader(TEXTURED_QUAD_SHADER)
@@ -305,6 +341,8 @@ struct Renderer::Impl
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &mMaxTextureSize);
+
     // Set up a VBO for streaming data to the GPU, stays bound all the time
     glGenBuffers(1, &mStreamVbo);
     glBindBuffer(GL_ARRAY_BUFFER, mStreamVbo);
@@ -355,6 +393,17 @@ struct Renderer::Impl
 
     glDeleteBuffers(1, &mStreamVbo);
     glDeleteBuffers(1, &mQuadIndicesEbo);
+
+    for (const auto& readback : mPendingReadbacks)
+    {
+      glDeleteBuffers(1, &readback.mPbo);
+    }
+
+    if (!mFreeReadbackPbos.empty())
+    {
+      glDeleteBuffers(
+        GLsizei(mFreeReadbackPbos.size()), mFreeReadbackPbos.data());
+    }
   }
 
 
@@ -522,6 +571,26 @@ struct Renderer::Impl
   }
 
 
+  void drawPoints(
+    const base::ArrayView<base::Vec2> positions,
+    const base::Color& color)
+  {
+    updateState(mRenderMode, RenderMode::Points);
+
+    const auto r = color.r / 255.0f;
+    const auto g = color.g / 255.0f;
+    const auto b = color.b / 255.0f;
+    const auto a = color.a / 255.0f;
+
+    for (const auto& position : positions)
+    {
+      float vertices[] = {float(position.x), float(position.y), r, g, b, a};
+      mBatchData.insert(
+        std::end(mBatchData), std::begin(vertices), std::end(vertices));
+    }
+  }
+
+
   void drawCustomQuadBatch(const CustomQuadBatchData& batch)
   {
     submitBatch();
@@ -602,6 +671,57 @@ struct Renderer::Impl
   }
 
 
+  void blitRenderTarget(
+    const TextureId renderTarget,
+    const base::Rect<int>& destRect)
+  {
+    // Make sure that the current render target is bound, and that pending
+    // draw calls end up beneath the copied image
+    submitBatch();
+
+    assert(mRenderTargetDict.count(renderTarget) != 0);
+
+#ifdef RIGEL_USE_GL_ES
+    // OpenGL ES 2.0 doesn't support framebuffer blits, so we draw a quad
+    // using default state instead.
+    pushState();
+    const auto currentTarget = mStateStack.back().mRenderTargetTexture;
+    mStateStack.back() = State{};
+    mStateStack.back().mRenderTargetTexture = currentTarget;
+    mStateChanged = true;
+
+    glBlendFunc(GL_ONE, GL_ZERO);
+    drawTexture(renderTarget, {0.0f, 0.0f, 1.0f, 1.0f}, destRect);
+    popState();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+#else
+    const auto& state = mStateStack.back();
+    const auto& source = mRenderTargetDict.find(renderTarget)->second;
+    const auto framebufferSize = currentRenderTargetSize();
+    const auto destBottom = framebufferSize.height - destRect.bottom() - 1;
+
+    // Blits are affected by the scissor test, so it needs to be disabled
+    // temporarily
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source.mFbo);
+    glBlitFramebuffer(
+      0,
+      0,
+      source.mSize.width,
+      source.mSize.height,
+      destRect.left(),
+      destBottom,
+      destRect.left() + destRect.size.width,
+      destBottom + destRect.size.height,
+      GL_COLOR_BUFFER_BIT,
+      GL_NEAREST);
+
+    commitRenderTarget(state);
+    commitClipRect(state, framebufferSize);
+#endif
+  }
+
+
   void pushState() { mStateStack.push_back(mStateStack.back()); }
 
 
@@ -688,6 +808,99 @@ struct Renderer::Impl
   }
 
 
+  void grabCurrentFramebufferAsync(
+    std::function<void(data::Image)> callback)
+  {
+    submitBatch();
+
+    const auto size = currentRenderTargetSize();
+
+#ifdef RIGEL_USE_GL_ES
+    auto pixels = data::PixelBuffer{size_t(size.width * size.height)};
+    glReadPixels(
+      0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    callback(
+      data::Image{std::move(pixels), size_t(size.width), size_t(size.height)});
+#else
+    GLuint pbo = 0;
+    if (!mFreeReadbackPbos.empty())
+    {
+      pbo = mFreeReadbackPbos.back();
+      mFreeReadbackPbos.pop_back();
+    }
+    else
+    {
+      glGenBuffers(1, &pbo);
+    }
+
+    // With a pixel pack buffer bound, glReadPixels returns immediately and
+    // the transfer happens asynchronously.
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+    glBufferData(
+      GL_PIXEL_PACK_BUFFER,
+      size.width * size.height * 4,
+      nullptr,
+      GL_STREAM_READ);
+    glReadPixels(
+      0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    mPendingReadbacks.push_back(
+      PendingReadback{pbo, size, READBACK_DELAY_FRAMES, std::move(callback)});
+#endif
+  }
+
+
+  void processPendingReadbacks()
+  {
+#ifndef RIGEL_USE_GL_ES
+    // Read backs are queued in order, and all use the same delay, so
+    // the ones that are ready are always at the front.
+    auto numCompleted = std::size_t{0};
+    for (auto& readback : mPendingReadbacks)
+    {
+      if (--readback.mFramesUntilReady > 0)
+      {
+        break;
+      }
+
+      ++numCompleted;
+    }
+
+    // Callbacks might start new read backs, so we take the completed ones out
+    // of the list before invoking any callbacks.
+    auto completedReadbacks = std::vector<PendingReadback>{
+      std::make_move_iterator(mPendingReadbacks.begin()),
+      std::make_move_iterator(mPendingReadbacks.begin() + numCompleted)};
+    mPendingReadbacks.erase(
+      mPendingReadbacks.begin(), mPendingReadbacks.begin() + numCompleted);
+
+    for (auto& readback : completedReadbacks)
+    {
+      const auto& size = readback.mSize;
+      const auto numBytes = size.width * size.height * 4;
+      auto pixels = data::PixelBuffer{size_t(size.width * size.height)};
+
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.mPbo);
+      if (
+        const auto pMappedData = glMapBufferRange(
+          GL_PIXEL_PACK_BUFFER, 0, numBytes, GL_MAP_READ_BIT))
+      {
+        std::memcpy(pixels.data(), pMappedData, numBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      }
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+      mFreeReadbackPbos.push_back(readback.mPbo);
+
+      readback.mCallback(
+        data::Image{std::move(pixels), size_t(size.width), size_t(size.height)});
+    }
+#endif
+  }
+
+
   template <typename StateT>
   void updateState(StateT& state, const StateT& newValue)
   {
@@ -708,6 +921,11 @@ struct Renderer::Impl
     submitBatch();
     SDL_GL_SwapWindow(mpWindow);
 
+    if (!mPendingReadbacks.empty())
+    {
+      processPendingReadbacks();
+    }
+
     const auto actualWindowSize = getSize(mpWindow);
     if (mWindowSize != actualWindowSize)
     {
@@ -953,7 +1171,9 @@ struct Renderer::Impl
   }
 
 
-  TextureId createTexture(const data::Image& image)
+  TextureId createTexture(
+    const data::Image& image,
+    const std::vector<data::Image>& mipLevels)
   {
     submitBatch();
 
@@ -965,6 +1185,35 @@ struct Renderer::Impl
       GLsizei(flippedImage.width()),
       GLsizei(flippedImage.height()),
       flippedImage.pixelData().data());
+
+#ifndef RIGEL_USE_GL_ES
+    if (!mipLevels.empty())
+    {
+      auto level = 1;
+      for (const auto& mipLevel : mipLevels)
+      {
+        const auto flippedLevel = mipLevel.flipped();
+        glTexImage2D(
+          GL_TEXTURE_2D,
+          level,
+          GL_RGBA,
+          GLsizei(flippedLevel.width()),
+          GLsizei(flippedLevel.height()),
+          0,
+          GL_RGBA,
+          GL_UNSIGNED_BYTE,
+          flippedLevel.pixelData().data());
+        ++level;
+      }
+
+      const auto numLevels = GLint(mipLevels.size());
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels);
+      glTexParameteri(
+        GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      mMipLevelsByTexture[handle] = numLevels;
+    }
+#endif
+
     glBindTexture(GL_TEXTURE_2D, mLastUsedTexture);
 
     ++mNumTextures;
@@ -972,6 +1221,121 @@ struct Renderer::Impl
   }
 
 
+  TextureId
+    createEmptyTexture(const int width, const int height, const int mipLevels)
+  {
+    submitBatch();
+
+    const auto handle =
+      createGlTexture(GLsizei(width), GLsizei(height), nullptr);
+
+#ifndef RIGEL_USE_GL_ES
+    const auto numLevels = mipLevels;
+    if (numLevels > 0)
+    {
+      for (auto level = 1; level <= numLevels; ++level)
+      {
+        glTexImage2D(
+          GL_TEXTURE_2D,
+          level,
+          GL_RGBA,
+          std::max(GLsizei(width) >> level, 1),
+          std::max(GLsizei(height) >> level, 1),
+          0,
+          GL_RGBA,
+          GL_UNSIGNED_BYTE,
+          nullptr);
+      }
+
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels);
+      glTexParameteri(
+        GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      mMipLevelsByTexture[handle] = numLevels;
+    }
+#else
+    static_cast<void>(mipLevels);
+    const auto numLevels = 0;
+#endif
+
+    // Texture contents are undefined after creation. Instead of uploading
+    // transparent pixels, we clear each level via a temporary framebuffer.
+    GLuint fboHandle;
+    glGenFramebuffers(1, &fboHandle);
+    glBindFramebuffer(GL_FRAMEBUFFER, fboHandle);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+    for (auto level = 0; level <= numLevels; ++level)
+    {
+      glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, handle, level);
+      glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    glDeleteFramebuffers(1, &fboHandle);
+
+    const auto& state = mStateStack.back();
+    commitRenderTarget(state);
+    commitClipRect(state, currentRenderTargetSize());
+    glBindTexture(GL_TEXTURE_2D, mLastUsedTexture);
+
+    ++mNumTextures;
+    return handle;
+  }
+
+
+  void updateTexture(
+    const TextureId texture,
+    const int textureHeight,
+    const base::Vec2& position,
+    const data::Image& image)
+  {
+    submitBatch();
+
+    auto uploadLevel = [&](const int level, const data::Image& levelImage) {
+      const auto flippedImage = levelImage.flipped();
+      const auto height = GLsizei(flippedImage.height());
+      const auto levelTextureHeight = std::max(textureHeight >> level, 1);
+
+      glTexSubImage2D(
+        GL_TEXTURE_2D,
+        level,
+        position.x >> level,
+        levelTextureHeight - (position.y >> level) - height,
+        GLsizei(flippedImage.width()),
+        height,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        flippedImage.pixelData().data());
+    };
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    uploadLevel(0, image);
+
+    // Keep mip levels in sync with the updated region. Downscaling rounds
+    // odd sizes down, which would drop the image's last row or column, so we
+    // pad the image first. The padding covers texture space which the
+    // caller has reserved for the image's alignment.
+    const auto iMipLevels = mMipLevelsByTexture.find(texture);
+    if (iMipLevels != mMipLevelsByTexture.end())
+    {
+      const auto numLevels = iMipLevels->second;
+      const auto mipLevels = data::createMipmaps(
+        paddedToMultipleOf(image, std::size_t{1} << numLevels), numLevels);
+
+      auto level = 1;
+      for (const auto& mipLevel : mipLevels)
+      {
+        uploadLevel(level, mipLevel);
+        ++level;
+      }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, mLastUsedTexture);
+  }
+
+
   TextureId
     createMonoTexture(int width, int height, base::ArrayView<std::uint8_t> data)
   {
@@ -1002,6 +1366,7 @@ struct Renderer::Impl
     }
     else
     {
+      mMipLevelsByTexture.erase(texture);
       --mNumTextures;
     }
 
@@ -1139,12 +1504,28 @@ void Renderer::drawPoint(const base::Vec2& position, const base::Color& color)
 }
 
 
+void Renderer::drawPoints(
+  const base::ArrayView<base::Vec2> positions,
+  const base::Color& color)
+{
+  mpImpl->drawPoints(positions, color);
+}
+
+
 void Renderer::drawCustomQuadBatch(const CustomQuadBatchData& batch)
 {
   mpImpl->drawCustomQuadBatch(batch);
 }
 
 
+void Renderer::blitRenderTarget(
+  const TextureId renderTarget,
+  const base::Rect<int>& destRect)
+{
+  mpImpl->blitRenderTarget(renderTarget, destRect);
+}
+
+
 void Renderer::submitVertexBuffers(
   const base::ArrayView<VertexBufferId> buffers,
   const TextureId texture)
@@ -1223,6 +1604,12 @@ base::Size Renderer::windowSize() const
 }
 
 
+int Renderer::maxTextureSize() const
+{
+  return mpImpl->mMaxTextureSize;
+}
+
+
 void Renderer::setRenderTarget(const TextureId target)
 {
   mpImpl->setRenderTarget(target);
@@ -1235,6 +1622,13 @@ data::Image Renderer::grabCurrentFramebuffer()
 }
 
 
+void Renderer::grabCurrentFramebufferAsync(
+  std::function<void(data::Image)> callback)
+{
+  mpImpl->grabCurrentFramebufferAsync(std::move(callback));
+}
+
+
 void Renderer::swapBuffers()
 {
   mpImpl->swapBuffers();
@@ -1266,9 +1660,30 @@ TextureId Renderer::createRenderTargetTexture(const int width, const int height)
 }
 
 
-TextureId Renderer::createTexture(const data::Image& image)
+TextureId Renderer::createTexture(
+  const data::Image& image,
+  const std::vector<data::Image>& mipLevels)
+{
+  return mpImpl->createTexture(image, mipLevels);
+}
+
+
+TextureId Renderer::createEmptyTexture(
+  const int width,
+  const int height,
+  const int mipLevels)
+{
+  return mpImpl->createEmptyTexture(width, height, mipLevels);
+}
+
+
+void Renderer::updateTexture(
+  const TextureId texture,
+  const int textureHeight,
+  const base::Vec2& position,
+  const data::Image& image)
 {
-  return mpImpl->createTexture(image);
+  mpImpl->updateTexture(texture, textureHeight, position, image);
 }
 
 
@@ -28,6 +28,7 @@ RIGEL_DISABLE_WARNINGS
 RIGEL_RESTORE_WARNINGS
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -100,12 +101,32 @@ public:
    */
   void drawPoint(const base::Vec2& position, const base::Color& color);
 
+  /** Draw multiple pixels of the same color
+   *
+   * Equivalent to calling drawPoint() for each position, but appends all
+   * points to the current batch at once.
+   */
+  void
+    drawPoints(base::ArrayView<base::Vec2> positions, const base::Color& color);
+
   void drawCustomQuadBatch(const CustomQuadBatchData& batch);
 
   void submitVertexBuffers(
     base::ArrayView<VertexBufferId> buffers,
     TextureId texture);
 
+  /** Copy render target contents into given area of the current framebuffer
+   *
+   * Scaling uses nearest-neighbor filtering. The destination is given in
+   * framebuffer pixels. Global translation/scale, clip rect, color effects
+   * and blending are all ignored, the destination pixels are replaced as-is.
+   *
+   * Uses a framebuffer blit where available, which is cheaper than drawing
+   * a textured quad.
+   */
+  void
+    blitRenderTarget(TextureId renderTarget, const base::Rect<int>& destRect);
+
   /** Draw rectangle outline, 1 pixel wide
    *
    * _Warning_: Does not support batching, use sparingly or only for
@@ -190,8 +211,48 @@ public:
    *
    * When a texture is no longer needed, it must be destroyed using
    * destroyTexture().
+   *
+   * Optionally, pre-computed mipmap levels can be given (see
+   * data::createMipmaps()). The texture then uses trilinear filtering when
+   * drawn at a smaller size than the original. This is not supported on
+   * OpenGL ES 2, where the mip levels are ignored.
+   */
+  TextureId createTexture(
+    const data::Image& image,
+    const std::vector<data::Image>& mipLevels = {});
+
+  /** Create a fully transparent texture
+   *
+   * This is a low-level API. Using the renderer::Texture class instead
+   * is recommended for most use cases.
+   *
+   * Like createTexture(), but without any image data. The texture can then
+   * be filled piece by piece using updateTexture(). The given number of mip
+   * levels is created in addition to the base level, with the same
+   * limitations as for createTexture().
    */
-  TextureId createTexture(const data::Image& image);
+  TextureId createEmptyTexture(int width, int height, int mipLevels = 0);
+
+  /** Replace part of a texture's contents
+   *
+   * This is a low-level API. Using the renderer::Texture class instead
+   * is recommended for most use cases.
+   *
+   * Uploads the given image into the texture, with its top-left corner at
+   * the given position. The texture's height is needed to translate the
+   * position into OpenGL's bottom-up coordinate system.
+   * The image must fit entirely into the texture.
+   *
+   * If the texture has mip levels, these are updated as well. In that case,
+   * the position must be a multiple of 2^(number of mip levels). The area
+   * right of and below the image up to the next such multiple must not be
+   * used for anything else, since the lower levels overwrite it.
+   */
+  void updateTexture(
+    TextureId texture,
+    int textureHeight,
+    const base::Vec2& position,
+    const data::Image& image);
 
   /** Create a render target texture
    *
@@ -365,9 +426,29 @@ public:
 
   data::Image grabCurrentFramebuffer();
 
+  /** Read back current framebuffer contents without stalling
+   *
+   * Like grabCurrentFramebuffer(), but instead of waiting for the GPU to
+   * finish rendering, the pixels are copied into a pixel buffer object and
+   * only retrieved after a couple more frames have been presented. The
+   * callback is invoked from within a later call to swapBuffers(). The image
+   * it receives is in OpenGL's bottom-up row order, flipping it is left to
+   * the caller so that it can be done off the main thread.
+   *
+   * On OpenGL ES 2, pixel buffer objects aren't available. The pixels are
+   * then read back immediately, and the callback is invoked right away.
+   *
+   * Read backs which are still pending when the renderer is destroyed are
+   * discarded.
+   */
+  void grabCurrentFramebufferAsync(std::function<void(data::Image)> callback);
+
   base::Size currentRenderTargetSize() const;
   base::Size windowSize() const;
 
+  /** Largest supported texture width/height, as reported by the driver */
+  int maxTextureSize() const;
+
   base::Vec2 globalTranslation() const;
   base::Vec2f globalScale() const;
   std::optional<base::Rect<int>> clipRect() const;
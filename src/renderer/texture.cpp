@@ -20,6 +20,8 @@
 #include "renderer/renderer.hpp"
 #include "renderer/shader.hpp"
 
+#include <algorithm>
+
 
 namespace rigel::renderer
 {
@@ -68,6 +70,12 @@ void Texture::render(
 }
 
 
+void Texture::update(const base::Vec2& position, const Image& image)
+{
+  mpRenderer->updateTexture(mId, mHeight, position, image);
+}
+
+
 Texture::Texture(renderer::Renderer* pRenderer, const Image& image)
   : Texture(
       pRenderer,
@@ -78,6 +86,32 @@ Texture::Texture(renderer::Renderer* pRenderer, const Image& image)
 }
 
 
+Texture::Texture(
+  renderer::Renderer* pRenderer,
+  const Image& image,
+  const std::vector<Image>& mipLevels)
+  : Texture(
+      pRenderer,
+      pRenderer->createTexture(image, mipLevels),
+      static_cast<int>(image.width()),
+      static_cast<int>(image.height()))
+{
+}
+
+
+Texture::Texture(
+  renderer::Renderer* pRenderer,
+  const base::Size& size,
+  const int mipLevels)
+  : Texture(
+      pRenderer,
+      pRenderer->createEmptyTexture(size.width, size.height, mipLevels),
+      size.width,
+      size.height)
+{
+}
+
+
 Texture::~Texture()
 {
   if (mpRenderer)
@@ -87,6 +121,30 @@ Texture::~Texture()
 }
 
 
+int mipLevelsForReplacement(
+  const base::Size& imageSize,
+  const base::Size& originalSize)
+{
+  if (originalSize.width <= 0 || originalSize.height <= 0)
+  {
+    return 0;
+  }
+
+  auto scale = std::min(
+    imageSize.width / originalSize.width,
+    imageSize.height / originalSize.height);
+
+  auto levels = 0;
+  while (scale >= 2)
+  {
+    scale /= 2;
+    ++levels;
+  }
+
+  return levels;
+}
+
+
 void drawWithCustomShader(
   Renderer* pRenderer,
   const Texture& texture,
@@ -40,6 +40,15 @@ class Texture
 public:
   Texture() = default;
   Texture(Renderer* renderer, const data::Image& image);
+
+  /** Create texture with mipmaps, see Renderer::createTexture() */
+  Texture(
+    Renderer* renderer,
+    const data::Image& image,
+    const std::vector<data::Image>& mipLevels);
+
+  /** Create transparent texture, see Renderer::createEmptyTexture() */
+  Texture(Renderer* renderer, const base::Size& size, int mipLevels = 0);
   ~Texture();
 
   Texture(Texture&& other) noexcept
@@ -87,6 +96,13 @@ public:
     const base::Rect<int>& sourceRect,
     const base::Rect<int>& destRect) const;
 
+  /** Replace part of the texture with the given image
+   *
+   * The image must fit entirely into the texture when placed at the given
+   * position.
+   */
+  void update(const base::Vec2& position, const data::Image& image);
+
   int width() const { return mWidth; }
 
   int height() const { return mHeight; }
@@ -113,6 +129,17 @@ protected:
 };
 
 
+/** Number of mip levels worth creating for a high-res replacement image
+ *
+ * Replacement images are never drawn at a smaller size than the original
+ * image they replace, so we only need mip levels down to that size.
+ * Returns 0 if the image isn't larger than the original.
+ */
+int mipLevelsForReplacement(
+  const base::Size& imageSize,
+  const base::Size& originalSize);
+
+
 void drawWithCustomShader(
   Renderer* pRenderer,
   const Texture& texture,
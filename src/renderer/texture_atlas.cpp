@@ -20,10 +20,13 @@
 #include "renderer/renderer.hpp"
 
 RIGEL_DISABLE_WARNINGS
+#include <loguru.hpp>
 #include <stb_rect_pack.h>
 RIGEL_RESTORE_WARNINGS
 
 #include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <stdexcept>
 
 
@@ -33,87 +36,273 @@ namespace rigel::renderer
 namespace
 {
 
-constexpr auto ATLAS_WIDTH = 2048;
-constexpr auto ATLAS_HEIGHT = 1024;
+// Large enough to fit all of the original game's sprites into a single
+// texture. Pages only get bigger than this when a batch of images doesn't
+// fit, or when the atlas already holds a lot of images (see addImages()).
+constexpr auto DEFAULT_PAGE_WIDTH = 2048;
+constexpr auto DEFAULT_PAGE_HEIGHT = 1024;
+
+// Even if the GPU supports larger textures, we don't want to go beyond this
+// - a page of this size already takes 256 MB of memory.
+constexpr auto MAX_PAGE_SIZE = 8192;
+
 constexpr auto PADDING = 1;
 
-} // namespace
 
+// With mipmaps, we want each image to start at a multiple of
+// 2^(number of mip levels), so that the box filter used for creating the
+// mip levels doesn't mix pixels from neighboring images. Making all rect
+// sizes a multiple of that achieves this, since rect positions are always
+// sums of other rects' sizes. The padding is increased accordingly, so
+// that it doesn't vanish in the lower mip levels.
+int alignmentFor(const int mipLevels)
+{
+  return 1 << mipLevels;
+}
 
-TextureAtlas::TextureAtlas(
-  Renderer* pRenderer,
-  const std::vector<data::Image>& images)
-  : mpRenderer(pRenderer)
+
+int paddingFor(const int mipLevels)
+{
+  return PADDING * alignmentFor(mipLevels);
+}
+
+
+std::vector<stbrp_rect> createRects(
+  const std::vector<data::Image>& images,
+  const std::vector<int>& indices,
+  const int mipLevels)
 {
-  mAtlasMap.resize(images.size());
+  const auto alignment = alignmentFor(mipLevels);
+  const auto padding = paddingFor(mipLevels);
+  auto alignedSize = [alignment](const std::size_t size) {
+    const auto intSize = static_cast<int>(size);
+    return (intSize + alignment - 1) / alignment * alignment;
+  };
 
   std::vector<stbrp_rect> rects;
-  rects.reserve(images.size());
+  rects.reserve(indices.size());
 
-  auto index = 0;
-  for (const auto& image : images)
+  for (const auto index : indices)
   {
+    const auto& image = images[index];
     rects.push_back(stbrp_rect{
       index,
-      static_cast<stbrp_coord>(image.width() + 2 * PADDING),
-      static_cast<stbrp_coord>(image.height() + 2 * PADDING),
+      static_cast<stbrp_coord>(alignedSize(image.width() + 2 * padding)),
+      static_cast<stbrp_coord>(alignedSize(image.height() + 2 * padding)),
       0,
       0,
       0});
-    ++index;
   }
 
-  stbrp_context context;
-  std::vector<stbrp_node> nodes;
-  nodes.resize(ATLAS_WIDTH);
+  return rects;
+}
+
 
-  do
+base::Size determinePageSize(
+  const std::vector<stbrp_rect>& rects,
+  const std::int64_t minimumArea,
+  const int maxTextureSize)
+{
+  const auto maxPageSize = std::min(maxTextureSize, MAX_PAGE_SIZE);
+
+  auto totalArea = std::int64_t{0};
+  auto largestSize = base::Size{};
+  for (const auto& rect : rects)
+  {
+    totalArea += std::int64_t{rect.w} * rect.h;
+    largestSize.width = std::max(largestSize.width, int(rect.w));
+    largestSize.height = std::max(largestSize.height, int(rect.h));
+  }
+
+  // Rect packing is never perfect, so we leave some slack
+  const auto requiredArea =
+    std::max(totalArea + totalArea / 8, minimumArea);
+
+  auto size = base::Size{
+    std::min(DEFAULT_PAGE_WIDTH, maxPageSize),
+    std::min(DEFAULT_PAGE_HEIGHT, maxPageSize)};
+
+  auto fits = [&]() {
+    return std::int64_t{size.width} * size.height >= requiredArea &&
+      size.width >= largestSize.width && size.height >= largestSize.height;
+  };
+
+  while (!fits() && (size.width < maxPageSize || size.height < maxPageSize))
+  {
+    if (size.height < size.width || size.width >= maxPageSize)
+    {
+      size.height = std::min(size.height * 2, maxPageSize);
+    }
+    else
+    {
+      size.width = std::min(size.width * 2, maxPageSize);
+    }
+  }
+
+  return size;
+}
+
+} // namespace
+
+
+/** Packing state for one of the atlas textures
+ *
+ * We keep this around so that more images can be added to the texture
+ * later on. It lives on the heap, since the stbrp_context holds pointers
+ * to itself and thus can't be moved.
+ */
+struct TextureAtlas::PackingState
+{
+  PackingState(const base::Size& size, const int mipLevels)
+    : mNodes(size.width)
+    , mMipLevels(mipLevels)
   {
     stbrp_init_target(
-      &context,
-      ATLAS_WIDTH,
-      ATLAS_HEIGHT,
-      nodes.data(),
-      static_cast<int>(nodes.size()));
-
-    const auto result =
-      stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
-
-    // Not all images might fit into the first texture. If that happens, we
-    // separate off those that didn't fit, and then do another round, then
-    // repeat again if needed, until we've managed to place all images.
-    // We do this by shifting all successfully packed images to the end of
-    // the vector, so that we can easily delete them after processing them,
-    // with the unpacked images remaining.
-    const auto iFirstPacked = result
-      ? rects.begin()
-      : std::partition(rects.begin(), rects.end(), [](const stbrp_rect& rect) {
-          return !rect.was_packed;
-        });
-
-    if (!result && iFirstPacked == rects.end())
+      &mContext,
+      size.width,
+      size.height,
+      mNodes.data(),
+      static_cast<int>(mNodes.size()));
+
+    // Best-fit results in noticeably tighter packing than the default
+    // bottom-left heuristic. Rects are sorted by height in both cases.
+    stbrp_setup_heuristic(&mContext, STBRP_HEURISTIC_Skyline_BF_sortHeight);
+  }
+
+  stbrp_context mContext;
+  std::vector<stbrp_node> mNodes;
+
+  // Number of mip levels the texture was created with. Images added later
+  // must use the matching alignment.
+  int mMipLevels;
+};
+
+
+TextureAtlas::TextureAtlas(
+  Renderer* pRenderer,
+  const std::vector<data::Image>& images)
+  : TextureAtlas(pRenderer)
+{
+  addImages(images);
+}
+
+
+TextureAtlas::TextureAtlas(Renderer* pRenderer)
+  : mpRenderer(pRenderer)
+{
+}
+
+
+TextureAtlas::~TextureAtlas() = default;
+TextureAtlas::TextureAtlas(TextureAtlas&&) noexcept = default;
+TextureAtlas& TextureAtlas::operator=(TextureAtlas&&) noexcept = default;
+
+
+int TextureAtlas::addImages(const std::vector<data::Image>& images)
+{
+  const auto firstIndex = size();
+  mAtlasMap.resize(mAtlasMap.size() + images.size());
+
+  // Indices (into the images vector) of images which haven't been placed yet
+  std::vector<int> pendingImages(images.size());
+  std::iota(pendingImages.begin(), pendingImages.end(), 0);
+
+  // Place as many of the pending images as possible into the given texture.
+  // Textures start out fully transparent, so we only need to upload the
+  // images themselves. This also updates the texture's mip levels, but only
+  // for the areas covered by the images.
+  auto packInto = [&](const int textureIndex) {
+    auto& packingState = *mPackingStates[textureIndex];
+    auto& texture = mAtlasTextures[textureIndex];
+    const auto padding = paddingFor(packingState.mMipLevels);
+
+    auto rects = createRects(images, pendingImages, packingState.mMipLevels);
+    stbrp_pack_rects(
+      &packingState.mContext, rects.data(), static_cast<int>(rects.size()));
+
+    pendingImages.clear();
+    for (const auto& rect : rects)
     {
-      // If not even a single rect could be packed, we give up
+      if (!rect.was_packed)
+      {
+        pendingImages.push_back(rect.id);
+        continue;
+      }
+
+      const auto& image = images[rect.id];
+      const auto position = base::Vec2{rect.x + padding, rect.y + padding};
+      const auto size = base::Size{
+        static_cast<int>(image.width()), static_cast<int>(image.height())};
+      mAtlasMap[firstIndex + rect.id] =
+        TextureInfo{{position, size}, textureIndex};
+      mUsedArea += std::int64_t{size.width} * size.height;
+
+      texture.update(position, image);
+    }
+  };
+
+  // First, use up the space left in existing textures. A texture's number
+  // of mip levels is fixed on creation, so we can only use textures with at
+  // least as many levels as currently needed. Additional levels don't hurt.
+  auto existingTexturesFull = false;
+  for (auto i = 0; i < textureCount() && !pendingImages.empty(); ++i)
+  {
+    if (mPackingStates[i]->mMipLevels >= mMipLevels)
+    {
+      packInto(i);
+      existingTexturesFull = true;
+    }
+  }
+
+  const auto previousTextureCount = textureCount();
+
+  // Any remaining images go into new textures. These are sized to fit the
+  // remaining images. If we've run out of space in existing textures, we
+  // also make the new texture at least as large as all images added so far.
+  // Textures thus grow along with the atlas' contents, which keeps the
+  // number of textures low without allocating a lot of unused space upfront
+  // when images are added in many small batches.
+  while (!pendingImages.empty())
+  {
+    const auto pageSize = determinePageSize(
+      createRects(images, pendingImages, mMipLevels),
+      existingTexturesFull ? mUsedArea : 0,
+      mpRenderer->maxTextureSize());
+
+    mAtlasTextures.emplace_back(mpRenderer, pageSize, mMipLevels);
+    mPackingStates.push_back(
+      std::make_unique<PackingState>(pageSize, mMipLevels));
+    mTotalArea += std::int64_t{pageSize.width} * pageSize.height;
+
+    const auto numPendingBefore = pendingImages.size();
+    packInto(textureCount() - 1);
+
+    if (pendingImages.size() == numPendingBefore)
+    {
+      // If not even a single image could be packed into an empty texture,
+      // we give up
       throw std::runtime_error{"Failed to build texture atlas"};
     }
 
-    data::Image atlas{
-      static_cast<size_t>(ATLAS_WIDTH), static_cast<size_t>(ATLAS_HEIGHT)};
+    existingTexturesFull = true;
+  }
+
+  if (textureCount() != previousTextureCount)
+  {
+    LOG_F(
+      INFO,
+      "Texture atlas now uses %d textures, %.1f%% of space used",
+      textureCount(),
+      packingEfficiency() * 100.0f);
+  }
 
-    const auto textureIndex = static_cast<int>(mAtlasTextures.size());
-    std::for_each(iFirstPacked, rects.end(), [&](const stbrp_rect& packedRect) {
-      atlas.insertImage(
-        packedRect.x + PADDING, packedRect.y + PADDING, images[packedRect.id]);
-      mAtlasMap[packedRect.id] = TextureInfo{
-        {{packedRect.x + PADDING, packedRect.y + PADDING},
-         {packedRect.w - 2 * PADDING, packedRect.h - 2 * PADDING}},
-        textureIndex};
-    });
+  return firstIndex;
+}
 
-    mAtlasTextures.emplace_back(mpRenderer, std::move(atlas));
 
-    rects.erase(iFirstPacked, rects.end());
-  } while (!rects.empty());
+float TextureAtlas::packingEfficiency() const
+{
+  return mTotalArea > 0 ? float(double(mUsedArea) / double(mTotalArea)) : 0.0f;
 }
 
 
@@ -20,6 +20,10 @@
 #include "renderer/renderer.hpp"
 #include "renderer/texture.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 
 namespace rigel::renderer
 {
@@ -52,6 +56,44 @@ public:
    */
   TextureAtlas(Renderer* pRenderer, const std::vector<data::Image>& images);
 
+  /** Create an empty texture atlas, to be filled via addImages() */
+  explicit TextureAtlas(Renderer* pRenderer);
+
+  ~TextureAtlas();
+
+  TextureAtlas(TextureAtlas&&) noexcept;
+  TextureAtlas& operator=(TextureAtlas&&) noexcept;
+
+  /** Add more images to the atlas
+   *
+   * Images are packed into the free space left in existing textures, which
+   * are updated in place. Any images that don't fit go into newly created
+   * textures. Images added previously keep their location, so existing
+   * indices remain valid.
+   *
+   * Returns the index of the first of the added images, the remaining ones
+   * follow consecutively in the order given.
+   */
+  int addImages(const std::vector<data::Image>& images);
+
+  /** Set number of mip levels needed by images added from now on
+   *
+   * Meant for atlases holding high-res replacement images, see
+   * mipLevelsForReplacement(). Textures which have already been created
+   * keep their current number of mip levels. Images needing more levels
+   * than an existing texture has are not added to that texture.
+   */
+  void setMipLevels(const int levels) { mMipLevels = levels; }
+
+  /** Number of images contained in the atlas */
+  int size() const { return static_cast<int>(mAtlasMap.size()); }
+
+  /** Number of textures used to hold all images */
+  int textureCount() const { return static_cast<int>(mAtlasTextures.size()); }
+
+  /** Fraction of total texture space that is occupied by images (0 to 1) */
+  float packingEfficiency() const;
+
   /** Draw image from atlas at given location
    *
    * The index parameter corresponds to the index in the list given on
@@ -78,8 +120,14 @@ private:
     int mTextureIndex;
   };
 
+  struct PackingState;
+
   std::vector<TextureInfo> mAtlasMap;
   std::vector<Texture> mAtlasTextures;
+  std::vector<std::unique_ptr<PackingState>> mPackingStates;
+  std::int64_t mUsedArea = 0;
+  std::int64_t mTotalArea = 0;
+  int mMipLevels = 0;
   Renderer* mpRenderer;
 };
 
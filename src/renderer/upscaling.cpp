@@ -17,6 +17,7 @@
 #include "upscaling.hpp"
 
 #include "base/math_utils.hpp"
+#include "base/tracing.hpp"
 #include "data/game_traits.hpp"
 #include "renderer/renderer.hpp"
 #include "renderer/shader_code.hpp"
@@ -117,6 +118,18 @@ void setupRenderingViewport(
   }
 }
 
+[[nodiscard]] base::ScopeGuard
+  useConstantAlphaBlending(const std::uint8_t alphaMod)
+{
+  // We use OpenGL's blending here instead of the renderer's color modulation,
+  // because we don't need to implement the modulation feature in our custom
+  // sharp bilinear shader if we do it that way.
+  glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+  glBlendColor(0.0f, 0.0f, 0.0f, alphaMod / 255.0f);
+  return base::defer(
+    []() { glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); });
+}
+
 } // namespace
 
 
@@ -264,85 +277,167 @@ void UpscalingBuffer::present(
   const bool isWidescreenFrame,
   const bool perElementUpscaling)
 {
-  using UF = data::UpscalingFilter;
+  RIGEL_TRACE_SCOPE("UpscalingBuffer::present");
 
-  // We use OpenGL's blending here instead of the renderer's color modulation,
-  // because we don't need to implement the modulation feature in our custom
-  // sharp bilinear shader if we do it that way.
-  glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-  glBlendColor(0.0f, 0.0f, 0.0f, std::clamp(mAlphaMod / 255.0f, 0.0f, 1.0f));
+  presentTexture(mRenderTarget, isWidescreenFrame, perElementUpscaling);
+}
+
+
+void UpscalingBuffer::preserveContents()
+{
+  if (mPreservedContents.extents() != mRenderTarget.extents())
+  {
+    mPreservedContents = RenderTargetTexture{
+      mpRenderer, mRenderTarget.width(), mRenderTarget.height()};
+    mpRenderer->setFilteringEnabled(
+      mPreservedContents.data(),
+      mFilter == data::UpscalingFilter::Bilinear ||
+        mFilter == data::UpscalingFilter::SharpBilinear);
+  }
+
+  mpRenderer->submitBatch();
+
+  auto saved = mPreservedContents.bindAndReset();
+
+  // Replace the destination instead of blending, so that we get an exact
+  // copy even for pixels that aren't fully opaque.
+  glBlendFunc(GL_ONE, GL_ZERO);
   auto blendFuncGuard =
     base::defer([]() { glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); });
 
-  if (perElementUpscaling)
+  mRenderTarget.render(0, 0);
+  mpRenderer->submitBatch();
+}
+
+
+void UpscalingBuffer::presentPreservedContents(
+  const bool preservedFrameIsWidescreen,
+  const bool perElementUpscaling)
+{
+  RIGEL_TRACE_SCOPE("UpscalingBuffer::presentPreservedContents");
+
+  // The preserved contents are discarded when the configuration changes,
+  // since they don't match the new buffer anymore.
+  if (mPreservedContents.extents() != mRenderTarget.extents())
   {
     mpRenderer->clear();
-    mRenderTarget.render(0, 0);
-    mpRenderer->submitBatch();
     return;
   }
 
-  const auto windowWidth = float(mpRenderer->windowSize().width);
-  const auto windowHeight = float(mpRenderer->windowSize().height);
+  presentTexture(
+    mPreservedContents, preservedFrameIsWidescreen, perElementUpscaling);
+}
 
-  auto setUpViewport = [&](
-                         const int textureWidth,
-                         const int textureHeight,
-                         const base::Vec2f& scale) {
-    const auto usableWidth = textureWidth * scale.x;
-    const auto usableHeight = textureHeight * scale.y;
-    const auto offsetX = (windowWidth - usableWidth) / 2.0f;
-    const auto offsetY = (windowHeight - usableHeight) / 2.0f;
 
-    mpRenderer->setGlobalTranslation({int(offsetX), int(offsetY)});
-    mpRenderer->setGlobalScale(scale);
-  };
+void UpscalingBuffer::presentTexture(
+  const RenderTargetTexture& texture,
+  const bool isWidescreenFrame,
+  const bool perElementUpscaling)
+{
+  using UF = data::UpscalingFilter;
 
+  // When the buffer isn't being faded and doesn't need any filtering,
+  // we can copy it to the screen directly instead of drawing it.
+  // That's a lot cheaper on weak GPUs.
+  const auto canBlit = mAlphaMod == 255 &&
+    (perElementUpscaling || mFilter == UF::PixelPerfect);
 
-  mpRenderer->clear();
+  if (mAlphaMod == 0)
+  {
+    mpRenderer->clear();
+    return;
+  }
 
-  auto saved = renderer::saveState(mpRenderer);
+  if (perElementUpscaling)
+  {
+    // The buffer is as large as the window, so there's nothing left to
+    // clear when copying it
+    if (canBlit)
+    {
+      mpRenderer->blitRenderTarget(texture.data(), {{}, texture.extents()});
+      return;
+    }
+
+    auto blendFuncGuard = useConstantAlphaBlending(mAlphaMod);
+    mpRenderer->clear();
+    texture.render(0, 0);
+    mpRenderer->submitBatch();
+    return;
+  }
+
+  const auto windowWidth = float(mpRenderer->windowSize().width);
+  const auto windowHeight = float(mpRenderer->windowSize().height);
 
   if (mFilter == UF::PixelPerfect)
   {
     const auto usedWidth = isWidescreenFrame
-      ? mRenderTarget.width()
+      ? texture.width()
       : data::GameTraits::viewportWidthPx;
 
     const auto maxIntegerScaleFactor = float(std::min(
       mpRenderer->windowSize().width / usedWidth,
-      mpRenderer->windowSize().height / mRenderTarget.height()));
+      mpRenderer->windowSize().height / texture.height()));
     const auto scale = mAspectRatioCorrection
       ? base::Vec2f{PIXEL_PERFECT_SCALE_X, PIXEL_PERFECT_SCALE_Y}
       : base::Vec2f{maxIntegerScaleFactor, maxIntegerScaleFactor};
-    setUpViewport(usedWidth, mRenderTarget.height(), scale);
-    mRenderTarget.render(0, 0);
-  }
-  else
-  {
-    const auto info = renderer::determineViewport(mpRenderer);
-    mpRenderer->setGlobalScale(info.mScale);
 
-    if (isWidescreenFrame)
-    {
-      const auto offset =
-        renderer::determineWidescreenViewport(mpRenderer).mLeftPaddingPx;
-      mpRenderer->setGlobalTranslation({offset, 0});
-    }
-    else
-    {
-      mpRenderer->setGlobalTranslation(info.mOffset);
-    }
+    const auto usableWidth = usedWidth * scale.x;
+    const auto usableHeight = texture.height() * scale.y;
+    const auto offset = base::Vec2{
+      int((windowWidth - usableWidth) / 2.0f),
+      int((windowHeight - usableHeight) / 2.0f)};
 
-    if (mFilter == UF::SharpBilinear)
-    {
-      drawWithCustomShader(
-        mpRenderer, mRenderTarget, {0, 0}, mSharpBilinearShader);
-    }
-    else
+    if (canBlit)
     {
-      mRenderTarget.render(0, 0);
+      const auto destRect = base::Rect<int>{
+        offset,
+        {int(texture.width() * scale.x), int(texture.height() * scale.y)}};
+      if (destRect != base::Rect<int>{{}, mpRenderer->windowSize()})
+      {
+        mpRenderer->clear();
+      }
+
+      mpRenderer->blitRenderTarget(texture.data(), destRect);
+      return;
     }
+
+    auto blendFuncGuard = useConstantAlphaBlending(mAlphaMod);
+    mpRenderer->clear();
+
+    auto saved = renderer::saveState(mpRenderer);
+    mpRenderer->setGlobalTranslation(offset);
+    mpRenderer->setGlobalScale(scale);
+    texture.render(0, 0);
+    mpRenderer->submitBatch();
+    return;
+  }
+
+  auto blendFuncGuard = useConstantAlphaBlending(mAlphaMod);
+  mpRenderer->clear();
+
+  auto saved = renderer::saveState(mpRenderer);
+
+  const auto info = renderer::determineViewport(mpRenderer);
+  mpRenderer->setGlobalScale(info.mScale);
+
+  if (isWidescreenFrame)
+  {
+    const auto offset =
+      renderer::determineWidescreenViewport(mpRenderer).mLeftPaddingPx;
+    mpRenderer->setGlobalTranslation({offset, 0});
+  }
+  else
+  {
+    mpRenderer->setGlobalTranslation(info.mOffset);
+  }
+
+  if (mFilter == UF::SharpBilinear)
+  {
+    drawWithCustomShader(mpRenderer, texture, {0, 0}, mSharpBilinearShader);
+  }
+  else
+  {
+    texture.render(0, 0);
   }
 
   mpRenderer->submitBatch();
@@ -360,6 +455,7 @@ void UpscalingBuffer::updateConfiguration(const data::GameOptions& options)
   mAspectRatioCorrection = options.mAspectRatioCorrectionEnabled;
 
   mRenderTarget = createFullscreenRenderTarget(mpRenderer, options);
+  mPreservedContents = {};
 
   if (options.mPerElementUpscalingEnabled)
   {
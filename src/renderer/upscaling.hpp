@@ -88,13 +88,32 @@ public:
   void clear();
   void present(bool currentFrameIsWidescreen, bool perElementUpscaling);
 
+  /** Copy the buffer's current contents into a separate texture
+   *
+   * The copy can then be shown using presentPreservedContents(), while
+   * the buffer itself is used for rendering something else. This is used
+   * for screen fades: The old screen contents need to be faded out over
+   * several frames, but the client might already render the next screen
+   * in the same frame that requested the fade.
+   */
+  void preserveContents();
+  void presentPreservedContents(
+    bool preservedFrameIsWidescreen,
+    bool perElementUpscaling);
+
   std::uint8_t alphaMod() const { return mAlphaMod; }
 
   void setAlphaMod(std::uint8_t alphaMod);
   void updateConfiguration(const data::GameOptions& options);
 
 private:
+  void presentTexture(
+    const RenderTargetTexture& texture,
+    bool isWidescreenFrame,
+    bool perElementUpscaling);
+
   RenderTargetTexture mRenderTarget;
+  RenderTargetTexture mPreservedContents;
   Shader mSharpBilinearShader;
   Renderer* mpRenderer;
   data::UpscalingFilter mFilter;
@@ -584,20 +584,61 @@ void DukeScriptRunner::drawSprite(
   const int x,
   const int y)
 {
-  const auto actorData = mpResourceBundle->loadActor(id, mCurrentPalette);
-  const auto& frameData = actorData.mFrames.at(frame);
-  const auto& image = frameData.mFrameImage;
+  const auto& frameData = cachedSpriteFrame(id, frame);
 
-  const auto spriteHeightTiles =
-    data::pixelsToTiles(static_cast<int>(image.height()));
+  const auto spriteHeightTiles = data::pixelsToTiles(frameData.mSize.height);
   const auto pos = base::Vec2{x - 1, y};
   const auto topLeft = pos - base::Vec2(0, spriteHeightTiles - 1);
 
   const auto topLeftPx = data::tilesToPixels(topLeft);
   const auto drawOffsetPx = data::tilesToPixels(frameData.mDrawOffset);
 
-  renderer::Texture spriteTexture(mpRenderer, image);
-  spriteTexture.render(topLeftPx + drawOffsetPx);
+  mSpriteCache.mAtlas->draw(
+    frameData.mAtlasIndex, {topLeftPx + drawOffsetPx, frameData.mSize});
+}
+
+
+auto DukeScriptRunner::cachedSpriteFrame(
+  const data::ActorID id,
+  const int frame) -> const CachedSpriteFrame&
+{
+  if (!mSpriteCache.mFramesByActor.count(id))
+  {
+    mSpriteCache.mFramesByActor.emplace(id, std::vector<CachedSpriteFrame>{});
+    mSpriteCache.mAtlas.reset();
+  }
+
+  if (!mSpriteCache.mAtlas)
+  {
+    rebuildSpriteCache();
+  }
+
+  return mSpriteCache.mFramesByActor.at(id).at(frame);
+}
+
+
+void DukeScriptRunner::rebuildSpriteCache()
+{
+  std::vector<data::Image> images;
+
+  for (auto& [id, frames] : mSpriteCache.mFramesByActor)
+  {
+    auto actorData = mpResourceBundle->loadActor(id, mCurrentPalette);
+
+    frames.clear();
+    for (auto& frameData : actorData.mFrames)
+    {
+      const auto& image = frameData.mFrameImage;
+      frames.push_back(CachedSpriteFrame{
+        static_cast<int>(images.size()),
+        frameData.mDrawOffset,
+        base::Size{
+          static_cast<int>(image.width()), static_cast<int>(image.height())}});
+      images.push_back(std::move(frameData.mFrameImage));
+    }
+  }
+
+  mSpriteCache.mAtlas.emplace(mpRenderer, images);
 }
 
 
@@ -757,14 +798,20 @@ void DukeScriptRunner::drawCurrentKeyBindings()
 
 void DukeScriptRunner::updatePalette(const data::Palette16& palette)
 {
-  // TODO think about optimizing this maybe, to only update if actually
-  // changed, e.g. if (palette != mCurrentPalette) or maybe have a
-  // 'paletteSource' string (name of palette file or fullscreen image file),
-  // which can be compared to determine if update needed.
+  // Scripts set the palette for every full screen image they show, which
+  // is usually the same palette as before.
+  if (palette == mCurrentPalette)
+  {
+    return;
+  }
 
   mCurrentPalette = palette;
   mUiSpriteSheetRenderer =
     makeUiSpriteSheet(mpRenderer, *mpResourceBundle, mCurrentPalette);
+
+  // Sprites need to be decoded again with the new palette. The atlas will
+  // be rebuilt the next time a sprite is drawn.
+  mSpriteCache.mAtlas.reset();
 }
 
 
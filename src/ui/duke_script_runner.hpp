@@ -24,11 +24,14 @@
 #include "engine/timing.hpp"
 #include "frontend/game_mode.hpp"
 #include "renderer/texture.hpp"
+#include "renderer/texture_atlas.hpp"
 #include "ui/menu_element_renderer.hpp"
 #include "ui/menu_navigation.hpp"
 
 #include <cstddef>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 
 namespace rigel::ui
@@ -169,7 +172,30 @@ private:
   bool isInWaitState() const;
   void clearWaitState();
 
+  struct CachedSpriteFrame
+  {
+    int mAtlasIndex;
+    base::Vec2 mDrawOffset;
+    base::Size mSize;
+  };
+
+  /** Sprites drawn by scripts, decoded with the current palette
+   *
+   * Scripts tend to draw the same few sprites over and over (e.g. animated
+   * sprites in menus and story screens), so we keep all actors that have
+   * been drawn so far in a texture atlas. The atlas is rebuilt when an actor
+   * is drawn for the first time, or when the palette changes.
+   */
+  struct SpriteCache
+  {
+    std::unordered_map<data::ActorID, std::vector<CachedSpriteFrame>>
+      mFramesByActor;
+    std::optional<renderer::TextureAtlas> mAtlas;
+  };
+
   void drawSprite(data::ActorID id, int frame, int x, int y);
+  const CachedSpriteFrame& cachedSpriteFrame(data::ActorID id, int frame);
+  void rebuildSpriteCache();
   void updatePalette(const data::Palette16& palette);
 
   void drawSaveSlotNames(int selectedIndex);
@@ -216,6 +242,7 @@ private:
   IGameServiceProvider* mpServices;
   engine::TiledTexture mUiSpriteSheetRenderer;
   MenuElementRenderer mMenuElementRenderer;
+  SpriteCache mSpriteCache;
 
   renderer::RenderTargetTexture mCanvas;
 
@@ -37,7 +37,9 @@ const auto FILTER_WEIGHT = 0.9f;
 } // namespace
 
 
-void FpsDisplay::updateAndRender(const engine::TimeDelta totalElapsed)
+void FpsDisplay::updateAndRender(
+  const engine::TimeDelta totalElapsed,
+  const std::optional<renderer::FrameTimeStats>& frameTimeStats)
 {
   mPreFilteredFrameTime = base::lerp(
     static_cast<float>(totalElapsed), mPreFilteredFrameTime, PRE_FILTER_WEIGHT);
@@ -54,6 +56,12 @@ void FpsDisplay::updateAndRender(const engine::TimeDelta totalElapsed)
     << totalElapsed * 1000.0 << " ms";
   // clang-format on
 
+  if (frameTimeStats)
+  {
+    statsReport << " (+/- " << frameTimeStats->mStandardDeviation * 1000.0
+                << " ms)";
+  }
+
   const auto reportString = statsReport.str();
   drawText(reportString, 0, 0, {255, 255, 255, 255});
 }
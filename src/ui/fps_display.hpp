@@ -17,6 +17,9 @@
 #pragma once
 
 #include "engine/timing.hpp"
+#include "renderer/fps_limiter.hpp"
+
+#include <optional>
 
 
 namespace rigel::ui
@@ -25,7 +28,14 @@ namespace rigel::ui
 class FpsDisplay
 {
 public:
-  void updateAndRender(engine::TimeDelta elapsed);
+  /** Show current frame rate and frame time
+   *
+   * If frame time statistics are given, the frame time's standard deviation
+   * is shown as well, as an indicator for how smooth the frame pacing is.
+   */
+  void updateAndRender(
+    engine::TimeDelta elapsed,
+    const std::optional<renderer::FrameTimeStats>& frameTimeStats = {});
 
 
 private:
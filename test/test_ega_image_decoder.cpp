@@ -0,0 +1,173 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assets/bitwise_iter.hpp>
+#include <assets/ega_image_decoder.hpp>
+#include <base/warnings.hpp>
+#include <data/game_traits.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <catch.hpp>
+RIGEL_RESTORE_WARNINGS
+
+#include <random>
+
+
+using namespace rigel;
+using namespace assets;
+
+using data::GameTraits;
+
+
+namespace
+{
+
+// Straightforward bit-by-bit decoder, used as reference for the optimized
+// implementation.
+data::PixelBuffer decodeReference(
+  const ByteBuffer& bytes,
+  const std::size_t widthInTiles,
+  const data::Palette16& palette,
+  const data::TileImageType type)
+{
+  const auto isMasked = type == data::TileImageType::Masked;
+  const auto numTiles = bytes.size() / GameTraits::bytesPerTile(type);
+  const auto heightInTiles = (numTiles + widthInTiles - 1) / widthInTiles;
+  const auto stride = widthInTiles * GameTraits::tileSize;
+
+  data::PixelBuffer pixels(
+    widthInTiles * heightInTiles * GameTraits::tileSizeSquared);
+
+  BitWiseIterator<ByteBufferCIter> bitsIter(bytes.begin());
+  for (auto tile = 0u; tile < numTiles; ++tile)
+  {
+    const auto tileX = (tile % widthInTiles) * GameTraits::tileSize;
+    const auto tileY = (tile / widthInTiles) * GameTraits::tileSize;
+
+    for (auto y = 0u; y < GameTraits::tileSize; ++y)
+    {
+      std::array<bool, GameTraits::tileSize> mask{};
+      if (isMasked)
+      {
+        for (auto& maskBit : mask)
+        {
+          maskBit = *bitsIter++;
+        }
+      }
+
+      std::array<std::uint8_t, GameTraits::tileSize> indices{};
+      for (auto plane = 0u; plane < GameTraits::egaPlanes; ++plane)
+      {
+        for (auto& index : indices)
+        {
+          index |= (*bitsIter++ ? 1 : 0) << plane;
+        }
+      }
+
+      for (auto x = 0u; x < GameTraits::tileSize; ++x)
+      {
+        auto& pixel = pixels[tileX + x + (tileY + y) * stride];
+        pixel = palette[indices[x]];
+        if (mask[x])
+        {
+          pixel.a = 0;
+        }
+      }
+    }
+  }
+
+  return pixels;
+}
+
+
+ByteBuffer randomBytes(const std::size_t count)
+{
+  std::mt19937 generator{1234};
+  std::uniform_int_distribution<int> distribution{0, 255};
+
+  ByteBuffer result(count);
+  for (auto& byte : result)
+  {
+    byte = static_cast<std::uint8_t>(distribution(generator));
+  }
+
+  return result;
+}
+
+
+data::Palette16 testPalette()
+{
+  data::Palette16 palette;
+  for (auto i = 0u; i < palette.size(); ++i)
+  {
+    const auto value = static_cast<std::uint8_t>(i * 16);
+    palette[i] = data::Pixel{value, std::uint8_t(255 - value), value, 255};
+  }
+
+  return palette;
+}
+
+} // namespace
+
+
+TEST_CASE("EGA tiled image decoding matches bit-by-bit reference")
+{
+  const auto palette = testPalette();
+  const auto widthInTiles = std::size_t{5};
+
+  for (const auto type :
+       {data::TileImageType::Unmasked, data::TileImageType::Masked})
+  {
+    // 3 full rows of tiles plus 2 tiles of a 4th row
+    const auto numTiles = widthInTiles * 3 + 2;
+    const auto bytes = randomBytes(numTiles * GameTraits::bytesPerTile(type));
+
+    const auto image = loadTiledImage(bytes, widthInTiles, palette, type);
+
+    REQUIRE(image.width() == widthInTiles * GameTraits::tileSize);
+    REQUIRE(image.height() == 4 * GameTraits::tileSize);
+    CHECK(
+      image.pixelData() ==
+      decodeReference(bytes, widthInTiles, palette, type));
+  }
+}
+
+
+TEST_CASE("EGA planar buffer decoding matches bit-by-bit reference")
+{
+  const auto palette = testPalette();
+  const auto bytesPerPlane = std::size_t{40};
+  const auto bytes = randomBytes(bytesPerPlane * GameTraits::egaPlanes);
+
+  const auto pixels =
+    decodeSimplePlanarEgaBuffer(bytes.begin(), bytes.end(), palette);
+
+  // The planes are stored one after another, so the bit for pixel n in
+  // plane p is bit n in the p-th section of the buffer.
+  REQUIRE(pixels.size() == bytesPerPlane * GameTraits::pixelsPerEgaByte);
+  for (auto i = 0u; i < pixels.size(); ++i)
+  {
+    auto index = 0;
+    for (auto plane = 0u; plane < GameTraits::egaPlanes; ++plane)
+    {
+      const auto byte = bytes[plane * bytesPerPlane + i / 8];
+      const auto bit = (byte >> (7 - i % 8)) & 1;
+      index |= bit << plane;
+    }
+
+    REQUIRE(pixels[i] == palette[index]);
+  }
+}
@@ -0,0 +1,162 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <base/warnings.hpp>
+#include <engine/base_components.hpp>
+#include <engine/entity_activation_system.hpp>
+#include <engine/random_number_generator.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <catch.hpp>
+RIGEL_RESTORE_WARNINGS
+
+#include <vector>
+
+
+using namespace rigel;
+using namespace engine;
+using namespace engine::components;
+
+namespace ex = entityx;
+
+
+namespace
+{
+
+struct ActivationResult
+{
+  bool mIsActive;
+  bool mIsOnScreen;
+
+  bool operator==(const ActivationResult& other) const
+  {
+    return mIsActive == other.mIsActive &&
+      (!mIsActive || mIsOnScreen == other.mIsOnScreen);
+  }
+};
+
+
+std::vector<ActivationResult> collectResults(ex::EntityManager& es)
+{
+  std::vector<ActivationResult> results;
+  es.each<WorldPosition>([&](ex::Entity entity, const WorldPosition&) {
+    const auto isActive = entity.has_component<Active>();
+    results.push_back(
+      {isActive, isActive && entity.component<Active>()->mIsOnScreen});
+  });
+  return results;
+}
+
+
+void spawnEntity(
+  ex::EntityManager& es,
+  const base::Vec2& position,
+  const int policyIndex)
+{
+  using Policy = ActivationSettings::Policy;
+
+  auto entity = es.create();
+  entity.assign<WorldPosition>(position);
+  entity.assign<BoundingBox>(BoundingBox{{0, -2}, {3, 3}});
+
+  if (policyIndex == 1)
+  {
+    entity.assign<ActivationSettings>(Policy::Always);
+  }
+  else if (policyIndex == 2)
+  {
+    entity.assign<ActivationSettings>(Policy::AlwaysAfterFirstActivation);
+  }
+}
+
+} // namespace
+
+
+TEST_CASE("Entity activation system matches full scan")
+{
+  ex::EntityX reference;
+  ex::EntityX incremental;
+
+  EntityActivationSystem activationSystem{
+    incremental.entities, incremental.events};
+
+  RandomNumberGenerator rng;
+
+  for (int i = 0; i < 300; ++i)
+  {
+    const auto position = base::Vec2{rng.gen() * 2 - 40, rng.gen()};
+    const auto policyIndex = rng.gen() % 4;
+    spawnEntity(reference.entities, position, policyIndex);
+    spawnEntity(incremental.entities, position, policyIndex);
+  }
+
+  const auto viewportSize = base::Size{32, 20};
+  auto cameraPosition = base::Vec2{};
+
+  for (int tick = 0; tick < 400; ++tick)
+  {
+    // Sweep the camera across the whole area and back
+    cameraPosition.x = (tick % 200) * 3 - 50;
+    cameraPosition.y = (tick / 4) % 200;
+
+    markActiveEntities(reference.entities, cameraPosition, viewportSize);
+    activationSystem.update(
+      incremental.entities, cameraPosition, viewportSize);
+
+    REQUIRE(
+      collectResults(reference.entities) ==
+      collectResults(incremental.entities));
+
+    // Move active entities around, like game logic would
+    const auto dx = rng.gen() % 5 - 2;
+    const auto dy = rng.gen() % 5 - 2;
+    for (auto* pEs : {&reference.entities, &incremental.entities})
+    {
+      pEs->each<WorldPosition, Active>(
+        [&](ex::Entity, WorldPosition& position, const Active&) {
+          position += base::Vec2{dx, dy};
+        });
+    }
+
+    // Occasionally spawn and destroy entities
+    if (tick % 7 == 0)
+    {
+      const auto position = cameraPosition + base::Vec2{rng.gen() % 64, 4};
+      spawnEntity(reference.entities, position, 0);
+      spawnEntity(incremental.entities, position, 0);
+    }
+
+    if (tick % 11 == 0)
+    {
+      for (auto* pEs : {&reference.entities, &incremental.entities})
+      {
+        ex::Entity entityToDestroy;
+        pEs->each<WorldPosition, Active>(
+          [&](ex::Entity entity, const WorldPosition&, const Active&) {
+            if (!entityToDestroy)
+            {
+              entityToDestroy = entity;
+            }
+          });
+
+        if (entityToDestroy)
+        {
+          entityToDestroy.destroy();
+        }
+      }
+    }
+  }
+}
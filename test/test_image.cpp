@@ -0,0 +1,86 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <base/image.hpp>
+#include <base/warnings.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <catch.hpp>
+RIGEL_RESTORE_WARNINGS
+
+
+using namespace rigel;
+using data::Image;
+using data::Pixel;
+
+
+TEST_CASE("Image downscaling averages 2x2 blocks")
+{
+  const auto red = Pixel{255, 0, 0, 255};
+  const auto blue = Pixel{0, 0, 255, 255};
+  const auto transparent = Pixel{0, 0, 0, 0};
+
+  SECTION("Opaque pixels")
+  {
+    const auto image = Image{{red, blue, blue, red}, 2, 2};
+    const auto result = image.downscaledByHalf();
+
+    REQUIRE(result.width() == 1);
+    REQUIRE(result.height() == 1);
+    CHECK(result.pixelData()[0] == (Pixel{128, 0, 128, 255}));
+  }
+
+  SECTION("Transparent pixels don't affect color")
+  {
+    const auto image = Image{{red, transparent, transparent, red}, 2, 2};
+    const auto result = image.downscaledByHalf();
+
+    CHECK(result.pixelData()[0] == (Pixel{255, 0, 0, 128}));
+  }
+
+  SECTION("Fully transparent block")
+  {
+    const auto image = Image{{transparent, transparent}, 2, 1};
+    const auto result = image.downscaledByHalf();
+
+    REQUIRE(result.width() == 1);
+    REQUIRE(result.height() == 1);
+    CHECK(result.pixelData()[0] == transparent);
+  }
+
+  SECTION("Odd dimensions are rounded down")
+  {
+    const auto image = Image{5, 3};
+    const auto result = image.downscaledByHalf();
+
+    CHECK(result.width() == 2);
+    CHECK(result.height() == 1);
+  }
+}
+
+
+TEST_CASE("Mipmap chain creation")
+{
+  const auto image = Image{16, 8};
+  const auto levels = data::createMipmaps(image, 4);
+
+  REQUIRE(levels.size() == 4);
+  CHECK(levels[0].width() == 8);
+  CHECK(levels[0].height() == 4);
+  CHECK(levels[3].width() == 1);
+  CHECK(levels[3].height() == 1);
+  CHECK(data::createMipmaps(image, 0).empty());
+}
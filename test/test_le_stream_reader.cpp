@@ -0,0 +1,93 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assets/file_utils.hpp>
+#include <base/warnings.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <catch.hpp>
+RIGEL_RESTORE_WARNINGS
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+
+using namespace rigel;
+using namespace assets;
+
+
+TEST_CASE("LeStreamReader reads little-endian values")
+{
+  const auto data = ByteBuffer{
+    0x01, 0x34, 0x12, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0xF2, 0xFE, 0xFF};
+  LeStreamReader reader(data);
+
+  SECTION("Single values")
+  {
+    CHECK(reader.readU8() == 0x01);
+    CHECK(reader.readU16() == 0x1234);
+    CHECK(reader.readU24() == 0x123456);
+    CHECK(reader.readU32() == 0xF2345678);
+    CHECK(reader.peekU8() == 0xFE);
+    CHECK(reader.readS16() == -2);
+    CHECK(!reader.hasData());
+    CHECK_THROWS_AS(reader.readU8(), const std::runtime_error&);
+  }
+
+  SECTION("Bulk reads")
+  {
+    reader.skipBytes(1);
+
+    std::array<std::uint16_t, 2> words;
+    reader.readU16Array(words.data(), words.size());
+    CHECK(words[0] == 0x1234);
+    CHECK(words[1] == 0x3456);
+
+    std::array<std::uint32_t, 1> longWord;
+    reader.readU32Array(longWord.data(), longWord.size());
+    CHECK(longWord[0] == 0x34567812);
+
+    std::array<std::int16_t, 1> signedWord;
+    reader.readS16Array(signedWord.data(), signedWord.size());
+    CHECK(signedWord[0] == -270);
+
+    const auto remaining = reader.readBytes(1);
+    REQUIRE(remaining.size() == 1);
+    CHECK(remaining[0] == 0xFF);
+    CHECK(!reader.hasData());
+  }
+
+  SECTION("Bulk reads check size before reading anything")
+  {
+    std::vector<std::uint16_t> words(7);
+    CHECK_THROWS_AS(
+      reader.readU16Array(words.data(), words.size()),
+      const std::runtime_error&);
+    CHECK_THROWS_AS((void)reader.readBytes(13), const std::runtime_error&);
+    CHECK(reader.remainingData().size() == data.size());
+    CHECK(reader.readU8() == 0x01);
+  }
+
+  SECTION("Reading from a view")
+  {
+    reader.skipBytes(3);
+    LeStreamReader subReader(reader.readBytes(3));
+    CHECK(subReader.readU24() == 0x123456);
+    CHECK(!subReader.hasData());
+    CHECK(reader.readU8() == 0x78);
+  }
+}
@@ -0,0 +1,129 @@
+/* Copyright (C) 2021, Nikolai Wuttke. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <base/warnings.hpp>
+#include <data/map.hpp>
+#include <engine/random_number_generator.hpp>
+
+RIGEL_DISABLE_WARNINGS
+#include <catch.hpp>
+RIGEL_RESTORE_WARNINGS
+
+#include <array>
+
+
+using namespace rigel;
+using namespace data::map;
+
+
+namespace
+{
+
+bool scanRow(
+  const Map& map,
+  const int startX,
+  const int endX,
+  const int y,
+  const SolidEdge edge)
+{
+  for (auto x = startX; x <= endX; ++x)
+  {
+    if (map.collisionData(x, y).isSolidOn(edge))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+bool scanColumn(
+  const Map& map,
+  const int startY,
+  const int endY,
+  const int x,
+  const SolidEdge edge)
+{
+  for (auto y = startY; y <= endY; ++y)
+  {
+    if (map.collisionData(x, y).isSolidOn(edge))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace
+
+
+TEST_CASE("Span tests match tile by tile collision data")
+{
+  // Tile 0 is empty, tiles 1 to 16 cover all combinations of solid edges
+  auto attributes = TileAttributeDict::AttributeArray{};
+  for (std::uint16_t i = 0; i <= 16; ++i)
+  {
+    attributes.push_back(i == 0 ? 0 : static_cast<std::uint16_t>(i - 1));
+  }
+
+  // Use sizes which aren't a multiple of the mask word size
+  Map map{150, 70, TileAttributeDict{attributes}};
+  engine::RandomNumberGenerator rng;
+
+  const auto edges = std::array<SolidEdge, 5>{
+    SolidEdge::top(),
+    SolidEdge::bottom(),
+    SolidEdge::left(),
+    SolidEdge::right(),
+    SolidEdge::any()};
+
+  for (int round = 0; round < 20; ++round)
+  {
+    // Change some tiles, occasionally putting content on both layers, which
+    // makes the tile non-solid
+    for (int i = 0; i < 400; ++i)
+    {
+      const auto x = (rng.gen() * 7 + rng.gen()) % map.width();
+      const auto y = rng.gen() % map.height();
+      const auto layer = rng.gen() % 8 == 0 ? 1 : 0;
+      map.setTileAt(layer, x, y, rng.gen() % 17);
+    }
+
+    if (round % 5 == 0)
+    {
+      map.clearSection(rng.gen() % 100, rng.gen() % 50, 20, 10);
+    }
+
+    for (int i = 0; i < 500; ++i)
+    {
+      const auto start = rng.gen() % 170 - 10;
+      const auto end = start + rng.gen() % 80 - 2;
+      const auto other = rng.gen() % 90 - 10;
+
+      for (const auto& edge : edges)
+      {
+        REQUIRE(
+          map.hasSolidEdgeInRow(start, end, other, edge) ==
+          scanRow(map, start, end, other, edge));
+        REQUIRE(
+          map.hasSolidEdgeInColumn(start, end, other, edge) ==
+          scanColumn(map, start, end, other, edge));
+      }
+    }
+  }
+}
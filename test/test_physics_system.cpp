@@ -27,6 +27,7 @@ RIGEL_DISABLE_WARNINGS
 #include <catch.hpp>
 RIGEL_RESTORE_WARNINGS
 
+#include <functional>
 
 using namespace rigel;
 using namespace engine;
@@ -37,6 +38,27 @@ using namespace engine::components::parameter_aliases;
 namespace ex = entityx;
 
 
+namespace
+{
+
+struct CollisionEventListener : ex::Receiver<CollisionEventListener>
+{
+  explicit CollisionEventListener(
+    ex::EventManager& events,
+    std::function<void(const events::CollidedWithWorld&)> handler)
+    : mHandler(std::move(handler))
+  {
+    events.subscribe<events::CollidedWithWorld>(*this);
+  }
+
+  void receive(const events::CollidedWithWorld& event) { mHandler(event); }
+
+  std::function<void(const events::CollidedWithWorld&)> mHandler;
+};
+
+} // namespace
+
+
 TEST_CASE("Physics system works as expected")
 {
   ex::EntityX entityx;
@@ -426,4 +448,37 @@ TEST_CASE("Physics system works as expected")
       CHECK(collectedPositions == expectedPositions);
     }
   }
+
+
+  SECTION("Objects ignoring collisions and gravity pass through everything")
+  {
+    for (auto x = 0; x < 4; ++x)
+    {
+      map.setTileAt(0, x, 7, 1);
+    }
+
+    auto solidBody = entities.create();
+    solidBody.assign<BoundingBox>(BoundingBox{{0, 0}, {4, 3}});
+    solidBody.assign<WorldPosition>(0, 12);
+    solidBody.assign<SolidBody>();
+
+    auto numCollisionEvents = 0;
+    CollisionEventListener listener{
+      entityx.events,
+      [&](const events::CollidedWithWorld&) { ++numCollisionEvents; }};
+
+    body.mGravityAffected = false;
+    body.mIgnoreCollisions = true;
+    body.mVelocity = base::Vec2f{1.0f, 2.0f};
+
+    for (auto i = 0; i < 6; ++i)
+    {
+      runOneFrame();
+    }
+
+    CHECK(position == base::Vec2{6, 16});
+    CHECK(body.mVelocity == base::Vec2f{1.0f, 2.0f});
+    CHECK(!physicalObject.has_component<CollidedWithWorld>());
+    CHECK(numCollisionEvents == 0);
+  }
 }
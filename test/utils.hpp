@@ -51,6 +51,7 @@ struct MockServiceProvider : public rigel::IGameServiceProvider
   void scheduleGameQuit() override { }
   void switchGamePath(const std::filesystem::path&) override { }
   void markCurrentFrameAsWidescreen() override { }
+  void markCurrentFrameAsLoading() override { }
   bool isSharewareVersion() const override { return false; }
 
   const CommandLineOptions& commandLineOptions() const override